@@ -0,0 +1,484 @@
+/*
+  ==============================================================================
+
+	ProcessBlockBenchmark.cpp
+	Created: 16 Oct 2026 8:58:00pm
+	Author:  roeim
+
+	Runs SimpleEQAudioProcessor::processBlock in a loop without a host and
+	prints the timings as JSON. The cases start from a stereo, 512 sample,
+	48k, 12/12 dB/oct, biquad, float, 1x, IIR, one peak, static baseline and
+	vary one axis at a time from it, except for the slopes, which are crossed:
+	  - channel counts from mono to 64 (5.1, 7.1.4, 3rd order ambisonics, and
+	    the 32+ channel buses that run on the worker pool)
+	  - block sizes 16 to 4096
+	  - sample rates 44.1k to 192k
+	  - every LowCut/HighCut slope combination
+	  - biquad vs smoothed SVF topology
+	  - single vs double precision processing
+	  - 1x, 2x, 4x and 8x oversampling of the peaks and high cut
+	  - 1, 4 or all 8 peak bands enabled
+	  - the zero latency IIR chain vs the linear phase FIR
+	  - static parameters vs parameters automated on every block
+
+	Options:
+	  --quick              a handful of cases instead of the full sweep
+	  --seconds=<s>        audio seconds to time per case (default 1)
+	  --channels=<n,...>   only these channel counts (the same goes for the
+	                       filters below: the baseline takes the first
+	                       remaining value when its own is filtered out)
+	  --topology=<name>    only "biquad" or only "svf"
+	  --precision=<name>   only "float" or only "double"
+	  --oversampling=<n,...> only these factors (1, 2, 4, 8)
+	  --mode=<name>        only "iir" or only "linear"
+	  --peaks=<n,...>      only these numbers of enabled peak bands
+	  --output=<file>      write the JSON there instead of stdout
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "../Source/PluginProcessor.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <optional>
+
+//==============================================================================
+// Every heap allocation made on the benchmark thread while processBlock runs is counted.
+namespace {
+	thread_local bool countAllocations = false;
+	std::atomic<juce::int64> allocationCount{ 0 };
+
+	void *countedAllocation(std::size_t size, std::size_t alignment) {
+		if (countAllocations)
+			allocationCount.fetch_add(1, std::memory_order_relaxed);
+
+		size = juce::jmax<std::size_t>(size, 1);
+
+		void *p = alignment > alignof(std::max_align_t)
+			? std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment)
+			: std::malloc(size);
+
+		if (p == nullptr)
+			throw std::bad_alloc();
+
+		return p;
+	}
+}
+
+void *operator new(std::size_t size) { return countedAllocation(size, 0); }
+void *operator new[](std::size_t size) { return countedAllocation(size, 0); }
+void *operator new(std::size_t size, std::align_val_t al) { return countedAllocation(size, static_cast<std::size_t>(al)); }
+void *operator new[](std::size_t size, std::align_val_t al) { return countedAllocation(size, static_cast<std::size_t>(al)); }
+
+void operator delete(void *p) noexcept { std::free(p); }
+void operator delete[](void *p) noexcept { std::free(p); }
+void operator delete(void *p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void *p, std::size_t) noexcept { std::free(p); }
+void operator delete(void *p, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void *p, std::align_val_t) noexcept { std::free(p); }
+void operator delete(void *p, std::size_t, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void *p, std::size_t, std::align_val_t) noexcept { std::free(p); }
+
+//==============================================================================
+namespace {
+	using Clock = std::chrono::steady_clock;
+
+	struct BenchmarkCase {
+		int numChannels;
+		int blockSize;
+		double sampleRate;
+		Slope lowCutSlope, highCutSlope;
+		Topology topology;
+		juce::AudioProcessor::ProcessingPrecision precision;
+		int oversamplingOrder;
+		bool linearPhase;
+		int numPeakBands;
+		bool automated;
+	};
+
+	struct BenchmarkResult {
+		double nsPerSample{ 0 }, nsPerChannelSample{ 0 };
+		double meanBlockNs{ 0 }, p50{ 0 }, p90{ 0 }, p99{ 0 }, p999{ 0 }, maxBlockNs{ 0 };
+		double meanAllocations{ 0 };
+		juce::int64 maxAllocations{ 0 };
+		int latencySamples{ 0 };
+	};
+
+	constexpr int warmUpBlocks = 32;
+
+	void setParameter(SimpleEQAudioProcessor &processor, const juce::String &parameterID, float value) {
+		auto *param = processor.apvts.getParameter(parameterID);
+		jassert(param != nullptr);
+
+		param->setValueNotifyingHost(param->convertTo0to1(value));
+	}
+
+	/** Moves every continuous parameter a little, the way dense host automation would. */
+	void automate(SimpleEQAudioProcessor &processor, int blockIndex, int numPeakBands) {
+		const auto phase = static_cast<float>(blockIndex) * 0.01f;
+		const auto sweep = 0.5f + 0.5f * std::sin(phase);
+
+		setParameter(processor, "LowCut Freq", juce::mapToLog10(sweep * 0.3f, 20.f, 20000.f));
+		setParameter(processor, "HighCut Freq", juce::mapToLog10(0.7f + sweep * 0.3f, 20.f, 20000.f));
+
+		for (int band = 0; band < numPeakBands; ++band) {
+			setParameter(processor, getPeakParameterID(band, "Freq"), juce::mapToLog10(sweep, 20.f, 20000.f));
+			setParameter(processor, getPeakParameterID(band, "Gain"), juce::jmap(sweep, -24.f, 24.f));
+			setParameter(processor, getPeakParameterID(band, "Quality"), juce::jmap(sweep, 0.1f, 10.f));
+		}
+	}
+
+	double percentile(const std::vector<double> &sorted, double p) {
+		const auto index = static_cast<size_t>(p * static_cast<double>(sorted.size() - 1) + 0.5);
+		return sorted[juce::jmin(index, sorted.size() - 1)];
+	}
+
+	/** Times one case, or returns nothing if the processor won't take its channel count. */
+	template<typename SampleType>
+	std::optional<BenchmarkResult> run(const BenchmarkCase &c, double secondsOfAudio) {
+		SimpleEQAudioProcessor processor;
+
+		juce::AudioProcessor::BusesLayout layout;
+		layout.inputBuses.add(juce::AudioChannelSet::canonicalChannelSet(c.numChannels));
+		layout.outputBuses.add(juce::AudioChannelSet::canonicalChannelSet(c.numChannels));
+
+		// Otherwise it would run on the default stereo bus and be reported under the wrong channel count.
+		if (!processor.setBusesLayout(layout))
+			return std::nullopt;
+
+		setParameter(processor, "LowCut Slope", static_cast<float>(c.lowCutSlope));
+		setParameter(processor, "HighCut Slope", static_cast<float>(c.highCutSlope));
+		setParameter(processor, "Filter Topology", static_cast<float>(c.topology));
+		setParameter(processor, "Oversampling", static_cast<float>(c.oversamplingOrder));
+		setParameter(processor, "Processing Mode", c.linearPhase ? 1.f : 0.f);
+
+		for (int band = 0; band < maxPeakBands; ++band) {
+			setParameter(processor, getPeakParameterID(band, "Enabled"), band < c.numPeakBands ? 1.f : 0.f);
+			setParameter(processor, getPeakParameterID(band, "Gain"), 6.f);
+		}
+
+		processor.setProcessingPrecision(c.precision);
+		processor.setRateAndBufferSizeDetails(c.sampleRate, c.blockSize);
+		processor.prepareToPlay(c.sampleRate, c.blockSize);
+
+		juce::AudioBuffer<SampleType> noise(c.numChannels, c.blockSize);
+		juce::AudioBuffer<SampleType> buffer(c.numChannels, c.blockSize);
+		juce::MidiBuffer midi;
+
+		juce::Random random(0x5eed);
+		for (int ch = 0; ch < c.numChannels; ++ch) {
+			for (int i = 0; i < c.blockSize; ++i)
+				noise.setSample(ch, i, static_cast<SampleType>(random.nextFloat() * 2.f - 1.f));
+		}
+
+		const int numBlocks = juce::jmax(64, juce::roundToInt(secondsOfAudio * c.sampleRate / c.blockSize));
+
+		std::vector<double> blockNs;
+		blockNs.reserve(static_cast<size_t>(numBlocks));
+
+		juce::int64 totalAllocations = 0, maxAllocations = 0;
+
+		for (int b = 0; b < warmUpBlocks + numBlocks; ++b) {
+			buffer.makeCopyOf(noise, true);
+
+			if (c.automated)
+				automate(processor, b, c.numPeakBands);
+
+			allocationCount.store(0);
+			countAllocations = true;
+
+			const auto start = Clock::now();
+			processor.processBlock(buffer, midi);
+			const auto end = Clock::now();
+
+			countAllocations = false;
+
+			if (b < warmUpBlocks)
+				continue;
+
+			blockNs.push_back(std::chrono::duration<double, std::nano>(end - start).count());
+
+			const auto allocations = allocationCount.load();
+			totalAllocations += allocations;
+			maxAllocations = juce::jmax(maxAllocations, allocations);
+		}
+
+		BenchmarkResult result;
+		result.latencySamples = processor.getLatencySamples();
+
+		processor.releaseResources();
+
+		double totalNs = 0;
+		for (auto ns : blockNs)
+			totalNs += ns;
+
+		result.nsPerSample = totalNs / (static_cast<double>(numBlocks) * c.blockSize);
+		result.nsPerChannelSample = result.nsPerSample / c.numChannels;
+		result.meanBlockNs = totalNs / numBlocks;
+		result.meanAllocations = static_cast<double>(totalAllocations) / numBlocks;
+		result.maxAllocations = maxAllocations;
+
+		std::sort(blockNs.begin(), blockNs.end());
+		result.p50 = percentile(blockNs, 0.5);
+		result.p90 = percentile(blockNs, 0.9);
+		result.p99 = percentile(blockNs, 0.99);
+		result.p999 = percentile(blockNs, 0.999);
+		result.maxBlockNs = blockNs.back();
+
+		return result;
+	}
+
+	std::optional<BenchmarkResult> run(const BenchmarkCase &c, double secondsOfAudio) {
+		return c.precision == juce::AudioProcessor::doublePrecision
+			? run<double>(c, secondsOfAudio)
+			: run<float>(c, secondsOfAudio);
+	}
+
+	int slopeInDbPerOct(Slope slope) {
+		return (static_cast<int>(slope) + 1) * 12;
+	}
+
+	const char *topologyName(Topology topology) {
+		return topology == Topology_SmoothedSVF ? "svf" : "biquad";
+	}
+
+	const char *precisionName(juce::AudioProcessor::ProcessingPrecision precision) {
+		return precision == juce::AudioProcessor::doublePrecision ? "double" : "float";
+	}
+
+	juce::var toJSON(const BenchmarkCase &c, const BenchmarkResult &r) {
+		juce::DynamicObject::Ptr blockNs = new juce::DynamicObject();
+		blockNs->setProperty("mean", r.meanBlockNs);
+		blockNs->setProperty("p50", r.p50);
+		blockNs->setProperty("p90", r.p90);
+		blockNs->setProperty("p99", r.p99);
+		blockNs->setProperty("p99.9", r.p999);
+		blockNs->setProperty("max", r.maxBlockNs);
+
+		juce::DynamicObject::Ptr allocations = new juce::DynamicObject();
+		allocations->setProperty("mean", r.meanAllocations);
+		allocations->setProperty("max", r.maxAllocations);
+
+		juce::DynamicObject::Ptr result = new juce::DynamicObject();
+		result->setProperty("channels", c.numChannels);
+		result->setProperty("blockSize", c.blockSize);
+		result->setProperty("sampleRate", c.sampleRate);
+		result->setProperty("lowCutSlope", slopeInDbPerOct(c.lowCutSlope));
+		result->setProperty("highCutSlope", slopeInDbPerOct(c.highCutSlope));
+		result->setProperty("topology", topologyName(c.topology));
+		result->setProperty("precision", precisionName(c.precision));
+		result->setProperty("oversampling", 1 << c.oversamplingOrder);
+		result->setProperty("mode", c.linearPhase ? "linear" : "iir");
+		result->setProperty("peakBands", c.numPeakBands);
+		result->setProperty("latencySamples", r.latencySamples);
+		result->setProperty("parameters", c.automated ? "automated" : "static");
+		result->setProperty("nsPerSample", r.nsPerSample);
+		result->setProperty("nsPerChannelSample", r.nsPerChannelSample);
+		result->setProperty("blockNs", juce::var(blockNs.get()));
+		result->setProperty("allocationsPerBlock", juce::var(allocations.get()));
+
+		return juce::var(result.get());
+	}
+
+	std::vector<BenchmarkCase> makeCases(bool quick, std::vector<int> channelCounts, std::vector<Topology> topologies,
+										 std::vector<juce::AudioProcessor::ProcessingPrecision> precisions, std::vector<int> oversamplingOrders,
+										 std::vector<bool> modes, std::vector<int> peakBandCounts) {
+		if (channelCounts.empty()) {
+			channelCounts = quick
+				? std::vector<int>{ 2, 16, 64 }
+				: std::vector<int>{ 1, 2, 6, 12, 16, 32, 64 };
+		}
+
+		if (oversamplingOrders.empty())
+			oversamplingOrders = quick ? std::vector<int>{ 0, 2 } : std::vector<int>{ 0, 1, 2, 3 };
+
+		if (peakBandCounts.empty())
+			peakBandCounts = quick ? std::vector<int>{ 1, maxPeakBands } : std::vector<int>{ 1, 4, maxPeakBands };
+
+		const std::vector<int> blockSizes = quick
+			? std::vector<int>{ 64, 512 }
+			: std::vector<int>{ 16, 32, 64, 128, 256, 512, 1024, 2048, 4096 };
+
+		const std::vector<double> sampleRates = quick
+			? std::vector<double>{ 48000.0 }
+			: std::vector<double>{ 44100.0, 48000.0, 88200.0, 96000.0, 176400.0, 192000.0 };
+
+		const std::vector<Slope> slopes = quick
+			? std::vector<Slope>{ Slope_12, Slope_48 }
+			: std::vector<Slope>{ Slope_12, Slope_24, Slope_36, Slope_48 };
+
+		// Everything starts from one typical stereo configuration, and each axis is swept on its own from
+		// there. The filters on the command line narrow the axes, and the baseline picks from what's left.
+		const auto pick = [](const auto &values, auto preferred) {
+			return std::find(values.begin(), values.end(), preferred) != values.end() ? preferred : values.front();
+		};
+
+		BenchmarkCase baseline;
+		baseline.numChannels = pick(channelCounts, 2);
+		baseline.blockSize = pick(blockSizes, 512);
+		baseline.sampleRate = pick(sampleRates, 48000.0);
+		baseline.lowCutSlope = baseline.highCutSlope = Slope_12;
+		baseline.topology = pick(topologies, Topology_Biquad);
+		baseline.precision = pick(precisions, juce::AudioProcessor::singlePrecision);
+		baseline.oversamplingOrder = pick(oversamplingOrders, 0);
+		baseline.linearPhase = pick(modes, false);
+		baseline.numPeakBands = pick(peakBandCounts, 1);
+		baseline.automated = false;
+
+		std::vector<BenchmarkCase> cases{ baseline };
+
+		const auto sweep = [&](const auto &values, auto BenchmarkCase::*field) {
+			for (const auto &value : values) {
+				auto c = baseline;
+				c.*field = value;
+
+				// Neither makes a difference to the FIR, so its baseline is enough.
+				if (c.linearPhase && (c.topology != baseline.topology || c.oversamplingOrder != baseline.oversamplingOrder))
+					continue;
+
+				if (c.*field != baseline.*field)
+					cases.push_back(c);
+			}
+		};
+
+		sweep(channelCounts, &BenchmarkCase::numChannels);
+		sweep(blockSizes, &BenchmarkCase::blockSize);
+		sweep(sampleRates, &BenchmarkCase::sampleRate);
+
+		/*
+		Every LowCut/HighCut pair runs its own specialised kernel, so the slopes are crossed, not swept.
+		With oversampling on, the cuts split into a LowCut-only and a HighCut-only kernel, so the cross
+		runs once without and, if it's in the list, once with oversampling.
+		*/
+		std::vector<int> slopeOversamplingOrders{ baseline.oversamplingOrder };
+
+		for (auto order : oversamplingOrders)
+			if ((order == 0) != (baseline.oversamplingOrder == 0) && !baseline.linearPhase) {
+				slopeOversamplingOrders.push_back(order);
+				break;
+			}
+
+		for (auto oversamplingOrder : slopeOversamplingOrders)
+			for (auto lowCutSlope : slopes)
+				for (auto highCutSlope : slopes) {
+					auto c = baseline;
+					c.oversamplingOrder = oversamplingOrder;
+					c.lowCutSlope = lowCutSlope;
+					c.highCutSlope = highCutSlope;
+
+					// The baseline slopes at each order come from the baseline and the oversampling sweep.
+					if (lowCutSlope != baseline.lowCutSlope || highCutSlope != baseline.highCutSlope)
+						cases.push_back(c);
+				}
+
+		sweep(topologies, &BenchmarkCase::topology);
+		sweep(precisions, &BenchmarkCase::precision);
+		sweep(oversamplingOrders, &BenchmarkCase::oversamplingOrder);
+		sweep(modes, &BenchmarkCase::linearPhase);
+		sweep(peakBandCounts, &BenchmarkCase::numPeakBands);
+		sweep(std::vector<bool>{ false, true }, &BenchmarkCase::automated);
+
+		return cases;
+	}
+}
+
+//==============================================================================
+int main(int argc, char *argv[]) {
+	// The processor's parameter state and the coefficient designer expect JUCE to be initialised.
+	juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+	juce::ArgumentList args(argc, argv);
+
+	const bool quick = args.containsOption("--quick");
+
+	const auto secondsOption = args.getValueForOption("--seconds");
+	const double secondsOfAudio = secondsOption.isNotEmpty() ? secondsOption.getDoubleValue() : 1.0;
+
+	std::vector<int> channelCounts;
+	for (auto &count : juce::StringArray::fromTokens(args.getValueForOption("--channels"), ",", ""))
+		if (count.getIntValue() > 0)
+			channelCounts.push_back(count.getIntValue());
+
+	std::vector<Topology> topologies{ Topology_Biquad, Topology_SmoothedSVF };
+	const auto topologyOption = args.getValueForOption("--topology");
+	if (topologyOption == "biquad")
+		topologies = { Topology_Biquad };
+	else if (topologyOption == "svf")
+		topologies = { Topology_SmoothedSVF };
+
+	std::vector<juce::AudioProcessor::ProcessingPrecision> precisions{ juce::AudioProcessor::singlePrecision, juce::AudioProcessor::doublePrecision };
+	const auto precisionOption = args.getValueForOption("--precision");
+	if (precisionOption == "float")
+		precisions = { juce::AudioProcessor::singlePrecision };
+	else if (precisionOption == "double")
+		precisions = { juce::AudioProcessor::doublePrecision };
+
+	std::vector<int> oversamplingOrders;
+	for (auto &factor : juce::StringArray::fromTokens(args.getValueForOption("--oversampling"), ",", ""))
+		for (int order = 0; order <= SimpleEQAudioProcessor::maxOversamplingOrder; ++order)
+			if (factor.getIntValue() == 1 << order)
+				oversamplingOrders.push_back(order);
+
+	std::vector<bool> modes{ false, true };
+	const auto modeOption = args.getValueForOption("--mode");
+	if (modeOption == "iir")
+		modes = { false };
+	else if (modeOption == "linear")
+		modes = { true };
+
+	std::vector<int> peakBandCounts;
+	for (auto &count : juce::StringArray::fromTokens(args.getValueForOption("--peaks"), ",", ""))
+		if (juce::isPositiveAndNotGreaterThan(count.getIntValue(), maxPeakBands))
+			peakBandCounts.push_back(count.getIntValue());
+
+	const auto cases = makeCases(quick, channelCounts, topologies, precisions, oversamplingOrders, modes, peakBandCounts);
+
+	juce::Array<juce::var> results;
+
+	for (size_t i = 0; i < cases.size(); ++i) {
+		const auto &c = cases[i];
+
+		std::cerr << "[" << (i + 1) << "/" << cases.size() << "] "
+			<< c.numChannels << " ch, " << c.blockSize << " samples @ " << c.sampleRate << " Hz, "
+			<< slopeInDbPerOct(c.lowCutSlope) << "/" << slopeInDbPerOct(c.highCutSlope) << " dB/oct, "
+			<< topologyName(c.topology) << ", " << precisionName(c.precision) << ", "
+			<< (1 << c.oversamplingOrder) << "x, "
+			<< (c.linearPhase ? "linear" : "iir") << ", "
+			<< c.numPeakBands << " peaks, "
+			<< (c.automated ? "automated" : "static") << std::endl;
+
+		const auto result = run(c, secondsOfAudio);
+
+		if (!result.has_value()) {
+			std::cerr << "  skipped: the processor rejected a " << c.numChannels << " channel layout" << std::endl;
+			continue;
+		}
+
+		results.add(toJSON(c, *result));
+	}
+
+	juce::DynamicObject::Ptr report = new juce::DynamicObject();
+	report->setProperty("benchmark", "processBlock");
+	report->setProperty("secondsPerCase", secondsOfAudio);
+	report->setProperty("results", results);
+
+	const auto json = juce::JSON::toString(juce::var(report.get()));
+
+	const auto outputOption = args.getValueForOption("--output");
+	if (outputOption.isNotEmpty()) {
+		auto file = juce::File::getCurrentWorkingDirectory().getChildFile(outputOption);
+		if (!file.replaceWithText(json)) {
+			std::cerr << "Couldn't write " << file.getFullPathName() << std::endl;
+			return 1;
+		}
+	} else {
+		std::cout << json << std::endl;
+	}
+
+	return 0;
+}
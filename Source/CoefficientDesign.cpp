@@ -0,0 +1,222 @@
+/*
+  ==============================================================================
+
+	CoefficientDesign.cpp
+	Created: 16 Oct 2026 7:42:00pm
+	Author:  roeim
+
+  ==============================================================================
+*/
+
+#include "CoefficientDesign.h"
+
+namespace {
+	double prewarp(float frequency, double sampleRate) {
+		const auto nyquistSafe = juce::jmin(static_cast<double>(frequency), sampleRate * 0.49);
+		return std::tan(juce::MathConstants<double>::pi * nyquistSafe / sampleRate);
+	}
+
+	double getOversampledRate(const ChainSettings &chainSettings, double sampleRate) {
+		return sampleRate * static_cast<double>(1 << chainSettings.oversamplingOrder);
+	}
+
+	/** The damping of each second order section of a Butterworth filter with that many sections. */
+	void butterworthDamping(std::array<double, 4> &k, int numSections) {
+		const int order = numSections * 2;
+
+		for (int i = 0; i < numSections; ++i)
+			k[i] = 2.0 * std::sin((2 * i + 1) * juce::MathConstants<double>::pi / (2 * order));
+	}
+
+	BiquadCoefficients normalise(double b0, double b1, double b2, double a0, double a1, double a2) {
+		return { b0 / a0, b1 / a0, b2 / a0, a1 / a0, a2 / a0 };
+	}
+
+	// Bilinear second order sections, with g the prewarped cutoff and k = 1 / Q.
+	BiquadCoefficients highPass(double g, double k) {
+		const auto gg = g * g;
+		return normalise(1.0, -2.0, 1.0, 1.0 + g * k + gg, 2.0 * (gg - 1.0), 1.0 - g * k + gg);
+	}
+
+	BiquadCoefficients lowPass(double g, double k) {
+		const auto gg = g * g;
+		return normalise(gg, 2.0 * gg, gg, 1.0 + g * k + gg, 2.0 * (gg - 1.0), 1.0 - g * k + gg);
+	}
+
+	//==============================================================================
+	/*
+	Magnitude matched sections, after M. Vicanek, "Matched Second Order Digital Filters" (2016).
+	w0 is the centre frequency in radians per sample and k = 1 / Q of the analog prototype.
+	The squared magnitude of a biquad is (B0 phi0 + B1 phi1 + B2 phi2) / (A0 phi0 + A1 phi1 + A2 phi2),
+	so once the poles are fixed the zeros can be fitted to the analog magnitude at a few frequencies.
+	*/
+	struct MatchedPoles {
+		double a1, a2;
+		double A0, A1, A2;
+		double phi0, phi1, phi2;
+
+		// |A(w0)|^2, the denominator's squared magnitude at the centre frequency.
+		double atCentre() const { return A0 * phi0 + A1 * phi1 + A2 * phi2; }
+	};
+
+	double toRadians(float frequency, double sampleRate) {
+		const auto nyquistSafe = juce::jmin(static_cast<double>(frequency), sampleRate * 0.49);
+		return juce::MathConstants<double>::twoPi * nyquistSafe / sampleRate;
+	}
+
+	/** The impulse invariant poles of s^2 + k s + 1 scaled to w0. */
+	MatchedPoles matchPoles(double w0, double k) {
+		MatchedPoles p;
+
+		const auto q = 0.5 * k;
+		const auto decay = std::exp(-q * w0);
+
+		p.a1 = q <= 1.0
+			? -2.0 * decay * std::cos(std::sqrt(1.0 - q * q) * w0)
+			: -2.0 * decay * std::cosh(std::sqrt(q * q - 1.0) * w0);
+		p.a2 = decay * decay;
+
+		p.A0 = juce::square(1.0 + p.a1 + p.a2);
+		p.A1 = juce::square(1.0 - p.a1 + p.a2);
+		p.A2 = -4.0 * p.a2;
+
+		p.phi1 = juce::square(std::sin(0.5 * w0));
+		p.phi0 = 1.0 - p.phi1;
+		p.phi2 = 4.0 * p.phi0 * p.phi1;
+
+		return p;
+	}
+
+	BiquadCoefficients matchedHighPass(double w0, double k) {
+		const auto p = matchPoles(w0, k);
+		const auto b0 = std::sqrt(juce::jmax(0.0, p.atCentre())) / (4.0 * p.phi1 * k);
+
+		return { b0, -2.0 * b0, b0, p.a1, p.a2 };
+	}
+
+	BiquadCoefficients matchedLowPass(double w0, double k) {
+		const auto p = matchPoles(w0, k);
+
+		// Matched at DC and at the centre frequency, where the analog gain is Q.
+		const auto B0 = p.A0;
+		const auto B1 = juce::jmax(0.0, (p.atCentre() / (k * k) - B0 * p.phi0) / p.phi1);
+		const auto b0 = 0.5 * (std::sqrt(B0) + std::sqrt(B1));
+
+		return { b0, std::sqrt(B0) - b0, 0.0, p.a1, p.a2 };
+	}
+
+	/** The bell (s^2 + s A / Q + 1) / (s^2 + s / (A Q) + 1), matched at DC, the centre and Nyquist. */
+	BiquadCoefficients matchedPeak(double w0, double quality, double amplitude) {
+		const auto p = matchPoles(w0, 1.0 / (quality * amplitude));
+
+		const auto nyquist = juce::MathConstants<double>::pi / w0;
+		const auto real = juce::square(1.0 - nyquist * nyquist);
+		const auto gainAtNyquist = (real + juce::square(amplitude * nyquist / quality))
+			/ (real + juce::square(nyquist / (amplitude * quality)));
+
+		const auto B0 = p.A0;
+		const auto B1 = p.A1 * gainAtNyquist;
+		const auto B2 = (juce::square(amplitude * amplitude) * p.atCentre() - B0 * p.phi0 - B1 * p.phi1) / p.phi2;
+
+		const auto root0 = std::sqrt(B0), root1 = std::sqrt(B1);
+		const auto w = 0.5 * (root0 + root1);
+		const auto b0 = 0.5 * (w + std::sqrt(juce::jmax(0.0, w * w + B2)));
+
+		return { b0, 0.5 * (root0 - root1), -B2 / (4.0 * b0), p.a1, p.a2 };
+	}
+}
+
+void designLowCut(const ChainSettings &chainSettings, double sampleRate, CoefficientSet &set) {
+	set.numLowCutStages = chainSettings.lowCutSlope + 1;
+
+	const auto g = prewarp(chainSettings.lowCutFreq, sampleRate);
+	butterworthDamping(set.svf.lowCutK, set.numLowCutStages);
+
+	const auto w0 = toRadians(chainSettings.lowCutFreq, sampleRate);
+	const bool matched = chainSettings.designMethod == Design_MagnitudeMatched;
+
+	for (int i = 0; i < set.numLowCutStages; ++i)
+		set.lowCut[i] = matched ? matchedHighPass(w0, set.svf.lowCutK[i]) : highPass(g, set.svf.lowCutK[i]);
+
+	set.svf.lowCutG = g;
+}
+
+void designHighCut(const ChainSettings &chainSettings, double sampleRate, CoefficientSet &set) {
+	set.numHighCutStages = chainSettings.highCutSlope + 1;
+
+	const auto g = prewarp(chainSettings.highCutFreq, getOversampledRate(chainSettings, sampleRate));
+	butterworthDamping(set.svf.highCutK, set.numHighCutStages);
+
+	const auto w0 = toRadians(chainSettings.highCutFreq, getOversampledRate(chainSettings, sampleRate));
+	const bool matched = chainSettings.designMethod == Design_MagnitudeMatched;
+
+	for (int i = 0; i < set.numHighCutStages; ++i)
+		set.highCut[i] = matched ? matchedLowPass(w0, set.svf.highCutK[i]) : lowPass(g, set.svf.highCutK[i]);
+
+	set.svf.highCutG = g;
+}
+
+void designPeak(const ChainSettings &chainSettings, int band, double sampleRate, CoefficientSet &set) {
+	const auto &settings = chainSettings.peaks[static_cast<size_t>(band)];
+	set.peakEnabled[static_cast<size_t>(band)] = settings.enabled;
+
+	if (!settings.enabled)
+		return;
+
+	const auto g = prewarp(settings.freq, getOversampledRate(chainSettings, sampleRate));
+	const auto amplitude = std::pow(10.0, settings.gainInDecibels / 40.0);
+	const auto k = 1.0 / (settings.quality * amplitude);
+	const auto gg = g * g;
+
+	auto &peak = set.peaks[static_cast<size_t>(band)];
+
+	if (chainSettings.designMethod == Design_MagnitudeMatched) {
+		const auto w0 = toRadians(settings.freq, getOversampledRate(chainSettings, sampleRate));
+		peak = matchedPeak(w0, settings.quality, amplitude);
+	} else {
+		// The RBJ peak, rewritten in terms of g: the same filter as IIR::Coefficients::makePeakFilter.
+		peak = normalise(1.0 + g * k * amplitude * amplitude + gg, 2.0 * (gg - 1.0), 1.0 - g * k * amplitude * amplitude + gg,
+						 1.0 + g * k + gg, 2.0 * (gg - 1.0), 1.0 - g * k + gg);
+	}
+
+	auto &bell = set.svf.peaks[static_cast<size_t>(band)];
+	bell.g = g;
+	bell.k = k;
+	bell.m1 = k * (amplitude * amplitude - 1.0);
+}
+
+double getMagnitudeSquared(const BiquadCoefficients *sections, int numSections, double sinSquared) {
+	// The same sin^2(w/2) form as ResponseCurveCache, which stays accurate at low frequencies.
+	const auto s = sinSquared;
+	double magnitude = 1.0;
+
+	for (int i = 0; i < numSections; ++i) {
+		const auto &c = sections[i];
+
+		const auto numerator = juce::square(c.b0 + c.b1 + c.b2)
+			- 4.0 * s * (c.b0 * c.b1 + c.b1 * c.b2 + 4.0 * c.b0 * c.b2) + 16.0 * c.b0 * c.b2 * s * s;
+		const auto denominator = juce::square(1.0 + c.a1 + c.a2)
+			- 4.0 * s * (c.a1 + c.a1 * c.a2 + 4.0 * c.a2) + 16.0 * c.a2 * s * s;
+
+		magnitude *= numerator / denominator;
+	}
+
+	return magnitude;
+}
+
+CoefficientSet designCoefficients(const ChainSettings &chainSettings, double sampleRate) {
+	CoefficientSet set;
+
+	designLowCut(chainSettings, sampleRate, set);
+
+	for (int band = 0; band < maxPeakBands; ++band)
+		designPeak(chainSettings, band, sampleRate, set);
+
+	designHighCut(chainSettings, sampleRate, set);
+
+	set.topology = chainSettings.topology;
+	set.oversamplingOrder = chainSettings.oversamplingOrder;
+	set.linearPhase = chainSettings.linearPhase;
+
+	return set;
+}
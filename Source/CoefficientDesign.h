@@ -0,0 +1,87 @@
+/*
+  ==============================================================================
+
+	CoefficientDesign.h
+	Created: 16 Oct 2026 7:42:00pm
+	Author:  roeim
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "ParameterSnapshot.h"
+
+/*
+Normalised biquad coefficients (a0 == 1), in the same order
+juce::dsp::IIR::Coefficients stores them: b0, b1, b2, a1, a2.
+Kept in double so the double precision chain gets them unrounded.
+*/
+struct BiquadCoefficients {
+	double b0{ 1 }, b1{ 0 }, b2{ 0 }, a1{ 0 }, a2{ 0 };
+};
+
+/*
+Targets for the smoothed state-variable topology (Zavalishin's TPT SVF, in Simper's form).
+g = tan(pi * cutoff / sampleRate) and k = 1 / Q. Each bell adds m1 times its band-pass output.
+The audio thread glides g, k and m1 towards these and derives the rest per sample.
+*/
+struct SVFTargets {
+	struct Bell {
+		double g{ 0 }, k{ 1 }, m1{ 0 };
+	};
+
+	double lowCutG{ 0 }, highCutG{ 0 };
+	std::array<double, 4> lowCutK{}, highCutK{};
+
+	std::array<Bell, maxPeakBands> peaks;
+};
+
+/*
+Everything the audio thread needs to run the chain, designed up front.
+Plain values only, so copying one never touches the heap.
+*/
+struct CoefficientSet {
+	std::array<BiquadCoefficients, 4> lowCut, highCut;
+	std::array<BiquadCoefficients, maxPeakBands> peaks;
+
+	// Only enabled bands are designed, and only they run.
+	std::array<bool, maxPeakBands> peakEnabled{};
+
+	SVFTargets svf;
+
+	int numLowCutStages{ 1 }, numHighCutStages{ 1 };
+	Topology topology{ Topology_Biquad };
+
+	// The peaks and high cut are designed for 2^oversamplingOrder times the host rate.
+	int oversamplingOrder{ 0 };
+
+	// The IIR chain is idle while the linear phase FIR runs instead.
+	bool linearPhase{ false };
+};
+
+/*
+Closed-form designs, one band at a time: Butterworth cuts as cascades of second order sections,
+and RBJ peaks, all through the prewarped bilinear transform. They give the same filters as
+juce::dsp::FilterDesign and IIR::Coefficients::makePeakFilter, but write into an existing set
+and never allocate, so they're fine on the audio thread.
+
+With chainSettings.designMethod set to Design_MagnitudeMatched, the biquads are Vicanek's magnitude
+matched designs instead: the poles come from the analog prototype's impulse response and the zeros
+are fitted to its magnitude at DC, the centre frequency and Nyquist, so the curves stay close to
+the analog ones right up to Nyquist instead of cramping. The SVF targets are always bilinear,
+since the TPT structure is built around the bilinear transform.
+
+sampleRate is always the host's. The peaks and high cut are designed for the oversampled rate
+when chainSettings.oversamplingOrder asks for one, the low cut never is.
+*/
+void designLowCut(const ChainSettings &chainSettings, double sampleRate, CoefficientSet &set);
+void designPeak(const ChainSettings &chainSettings, int band, double sampleRate, CoefficientSet &set);
+void designHighCut(const ChainSettings &chainSettings, double sampleRate, CoefficientSet &set);
+
+/** Designs every band of the chain for these settings. */
+CoefficientSet designCoefficients(const ChainSettings &chainSettings, double sampleRate);
+
+/** The squared magnitude of a cascade of sections at the frequency w where sinSquared == sin^2(w / 2). */
+double getMagnitudeSquared(const BiquadCoefficients *sections, int numSections, double sinSquared);
@@ -0,0 +1,77 @@
+/*
+  ==============================================================================
+
+	CoefficientService.cpp
+	Created: 16 Oct 2026 7:42:00pm
+	Author:  roeim
+
+  ==============================================================================
+*/
+
+#include "CoefficientService.h"
+
+//==============================================================================
+CoefficientService::DesignerThread::DesignerThread(): juce::Thread("SimpleEQ Coefficient Designer") {}
+
+CoefficientService::DesignerThread::~DesignerThread() {
+	stopThread(1000);
+}
+
+void CoefficientService::DesignerThread::addClient(CoefficientService *service) {
+	const juce::ScopedLock sl(lock);
+	clients.addIfNotAlreadyThere(service);
+
+	if (!isThreadRunning())
+		startThread();
+}
+
+void CoefficientService::DesignerThread::removeClient(CoefficientService *service) {
+	// Taking the lock also waits for a redesign of this client that may be in flight.
+	const juce::ScopedLock sl(lock);
+	clients.removeFirstMatchingValue(service);
+}
+
+void CoefficientService::DesignerThread::run() {
+	while (!threadShouldExit()) {
+		{
+			const juce::ScopedLock sl(lock);
+			for (auto *client : clients)
+				client->redesignIfNeeded();
+		}
+
+		wait(pollIntervalMs);
+	}
+}
+
+//==============================================================================
+CoefficientService::CoefficientService(const ParameterSnapshot &snapshot): parameters(snapshot) {}
+
+CoefficientService::~CoefficientService() {
+	release();
+}
+
+void CoefficientService::prepare(double newSampleRate) {
+	// Unregister first, so the designer thread can't publish while we do.
+	designer->removeClient(this);
+
+	sampleRate = newSampleRate;
+	designedVersion = parameters.getVersion();
+	designAndPublish(parameters.load());
+
+	designer->addClient(this);
+}
+
+void CoefficientService::release() {
+	designer->removeClient(this);
+}
+
+void CoefficientService::redesignIfNeeded() {
+	ChainSettings chainSettings;
+	if (parameters.loadIfChanged(chainSettings, designedVersion))
+		designAndPublish(chainSettings);
+}
+
+void CoefficientService::designAndPublish(const ChainSettings &chainSettings) {
+	published.getWriteBuffer() = designCoefficients(chainSettings, sampleRate);
+	published.publish();
+}
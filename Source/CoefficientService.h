@@ -0,0 +1,71 @@
+/*
+  ==============================================================================
+
+	CoefficientService.h
+	Created: 16 Oct 2026 7:42:00pm
+	Author:  roeim
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "CoefficientDesign.h"
+#include "LockFree.h"
+#include "ParameterSnapshot.h"
+
+/*
+Redesigns the filter coefficients whenever a parameter changes, away from the audio thread,
+and hands finished sets to the audio thread through a TripleBuffer.
+
+A single designer thread shared by every plugin instance in the process watches each
+instance's ParameterSnapshot version and only redesigns when it moved.
+*/
+class CoefficientService {
+public:
+	CoefficientService(const ParameterSnapshot &parameters);
+	~CoefficientService();
+
+	/** Designs a set for the new sample rate on the calling thread and starts following parameter changes. */
+	void prepare(double sampleRate);
+
+	/** Stops redesigning until the next prepare(). */
+	void release();
+
+	/**
+	Audio thread only. Wait-free.
+	Returns the newest set if one was published since the last call, nullptr otherwise.
+	*/
+	const CoefficientSet *pullNewCoefficients() {
+		return published.acquire() ? &published.getReadBuffer() : nullptr;
+	}
+
+private:
+	struct DesignerThread: juce::Thread {
+		DesignerThread();
+		~DesignerThread() override;
+
+		void addClient(CoefficientService *service);
+		void removeClient(CoefficientService *service);
+
+		void run() override;
+
+	private:
+		static constexpr int pollIntervalMs = 1;
+
+		juce::CriticalSection lock;
+		juce::Array<CoefficientService *> clients;
+	};
+
+	const ParameterSnapshot &parameters;
+	juce::SharedResourcePointer<DesignerThread> designer;
+
+	TripleBuffer<CoefficientSet> published;
+
+	juce::uint32 designedVersion{ 0 };
+	double sampleRate{ 0 };
+
+	void redesignIfNeeded();
+	void designAndPublish(const ChainSettings &chainSettings);
+};
@@ -0,0 +1,182 @@
+/*
+  ==============================================================================
+
+	ControlRateDesigner.cpp
+	Created: 16 Oct 2026 11:05:00pm
+	Author:  roeim
+
+  ==============================================================================
+*/
+
+#include "ControlRateDesigner.h"
+
+namespace {
+	// The last step lands exactly on the designed value, not just within rounding of it.
+	double interpolated(double from, double to, double proportion) {
+		return proportion < 1.0 ? from + proportion * (to - from) : to;
+	}
+
+	BiquadCoefficients interpolated(const BiquadCoefficients &from, const BiquadCoefficients &to, double proportion) {
+		return { interpolated(from.b0, to.b0, proportion), interpolated(from.b1, to.b1, proportion),
+				 interpolated(from.b2, to.b2, proportion), interpolated(from.a1, to.a1, proportion),
+				 interpolated(from.a2, to.a2, proportion) };
+	}
+
+	bool differs(const BiquadCoefficients &a, const BiquadCoefficients &b) {
+		return a.b0 != b.b0 || a.b1 != b.b1 || a.b2 != b.b2 || a.a1 != b.a1 || a.a2 != b.a2;
+	}
+
+	bool differs(const std::array<BiquadCoefficients, 4> &a, const std::array<BiquadCoefficients, 4> &b, int numStages) {
+		for (int i = 0; i < numStages; ++i)
+			if (differs(a[static_cast<size_t>(i)], b[static_cast<size_t>(i)]))
+				return true;
+
+		return false;
+	}
+
+	bool differs(const SVFTargets::Bell &a, const SVFTargets::Bell &b) {
+		return a.g != b.g || a.k != b.k || a.m1 != b.m1;
+	}
+}
+
+ControlRateDesigner::ControlRateDesigner(const ParameterSnapshot &snapshot): parameters(snapshot), service(snapshot) {}
+
+void ControlRateDesigner::prepare(double newSampleRate, int samplesPerTick) {
+	sampleRate = newSampleRate;
+	rampTicks = juce::jmax(1, juce::roundToInt(rampSeconds * sampleRate / samplesPerTick));
+
+	// The service designs the first set right here, so it's in place before the first sample.
+	seenVersion = parameters.getVersion();
+	service.prepare(sampleRate);
+
+	if (auto *designed = service.pullNewCoefficients())
+		coefficients = *designed;
+
+	from = target = coefficients;
+	ticksLeft = 0;
+	lowCutMoving = highCutMoving = false;
+	peakMoving = {};
+	needsUpdate = true;
+}
+
+void ControlRateDesigner::release() {
+	service.release();
+}
+
+bool ControlRateDesigner::startRamp(const CoefficientSet &next) {
+	const bool switchAll = next.topology != coefficients.topology || next.linearPhase != coefficients.linearPhase;
+
+	// The peaks and high cut are designed for the oversampled rate, so a new factor switches them all.
+	const bool switchOversampled = switchAll || next.oversamplingOrder != coefficients.oversamplingOrder;
+	const bool switchLowCut = switchAll || next.numLowCutStages != coefficients.numLowCutStages;
+	const bool switchHighCut = switchOversampled || next.numHighCutStages != coefficients.numHighCutStages;
+
+	// Ramps start from wherever the last one got to.
+	from = coefficients;
+	target = next;
+
+	bool switched = switchAll;
+
+	lowCutMoving = !switchLowCut
+		&& (differs(from.lowCut, target.lowCut, target.numLowCutStages) || from.svf.lowCutG != target.svf.lowCutG);
+
+	if (switchLowCut) {
+		coefficients.lowCut = target.lowCut;
+		coefficients.svf.lowCutG = target.svf.lowCutG;
+		coefficients.svf.lowCutK = target.svf.lowCutK;
+		coefficients.numLowCutStages = target.numLowCutStages;
+		switched = true;
+	}
+
+	highCutMoving = !switchHighCut
+		&& (differs(from.highCut, target.highCut, target.numHighCutStages) || from.svf.highCutG != target.svf.highCutG);
+
+	if (switchHighCut) {
+		coefficients.highCut = target.highCut;
+		coefficients.svf.highCutG = target.svf.highCutG;
+		coefficients.svf.highCutK = target.svf.highCutK;
+		coefficients.numHighCutStages = target.numHighCutStages;
+		switched = true;
+	}
+
+	for (size_t band = 0; band < peakMoving.size(); ++band) {
+		// A band that's off has nothing to glide from, so it comes back in at its new values.
+		const bool switchPeak = switchOversampled || target.peakEnabled[band] != from.peakEnabled[band];
+
+		peakMoving[band] = !switchPeak && target.peakEnabled[band]
+			&& (differs(from.peaks[band], target.peaks[band]) || differs(from.svf.peaks[band], target.svf.peaks[band]));
+
+		if (switchPeak) {
+			coefficients.peaks[band] = target.peaks[band];
+			coefficients.svf.peaks[band] = target.svf.peaks[band];
+			coefficients.peakEnabled[band] = target.peakEnabled[band];
+			switched = true;
+		}
+	}
+
+	coefficients.topology = target.topology;
+	coefficients.oversamplingOrder = target.oversamplingOrder;
+	coefficients.linearPhase = target.linearPhase;
+
+	bool anyPeakMoving = false;
+	for (auto moving : peakMoving)
+		anyPeakMoving |= moving;
+
+	ticksLeft = lowCutMoving || highCutMoving || anyPeakMoving ? rampTicks : 0;
+	return switched;
+}
+
+void ControlRateDesigner::interpolate(double proportion) {
+	if (lowCutMoving) {
+		for (int i = 0; i < target.numLowCutStages; ++i)
+			coefficients.lowCut[static_cast<size_t>(i)] = interpolated(from.lowCut[static_cast<size_t>(i)], target.lowCut[static_cast<size_t>(i)], proportion);
+
+		coefficients.svf.lowCutG = interpolated(from.svf.lowCutG, target.svf.lowCutG, proportion);
+	}
+
+	if (highCutMoving) {
+		for (int i = 0; i < target.numHighCutStages; ++i)
+			coefficients.highCut[static_cast<size_t>(i)] = interpolated(from.highCut[static_cast<size_t>(i)], target.highCut[static_cast<size_t>(i)], proportion);
+
+		coefficients.svf.highCutG = interpolated(from.svf.highCutG, target.svf.highCutG, proportion);
+	}
+
+	for (size_t band = 0; band < peakMoving.size(); ++band) {
+		if (!peakMoving[band])
+			continue;
+
+		coefficients.peaks[band] = interpolated(from.peaks[band], target.peaks[band], proportion);
+
+		auto &bell = coefficients.svf.peaks[band];
+		const auto &fromBell = from.svf.peaks[band];
+		const auto &targetBell = target.svf.peaks[band];
+
+		bell.g = interpolated(fromBell.g, targetBell.g, proportion);
+		bell.k = interpolated(fromBell.k, targetBell.k, proportion);
+		bell.m1 = interpolated(fromBell.m1, targetBell.m1, proportion);
+	}
+}
+
+const CoefficientSet *ControlRateDesigner::tick(bool designOnTick) {
+	bool changed = needsUpdate;
+	needsUpdate = false;
+
+	if (designOnTick) {
+		// Anything the designer thread publishes meanwhile is from the same changes, just later.
+		service.pullNewCoefficients();
+
+		ChainSettings chainSettings;
+		if (parameters.loadIfChanged(chainSettings, seenVersion))
+			changed |= startRamp(designCoefficients(chainSettings, sampleRate));
+	} else if (auto *designed = service.pullNewCoefficients()) {
+		changed |= startRamp(*designed);
+	}
+
+	if (ticksLeft > 0) {
+		--ticksLeft;
+		interpolate(1.0 - static_cast<double>(ticksLeft) / rampTicks);
+		changed = true;
+	}
+
+	return changed ? &coefficients : nullptr;
+}
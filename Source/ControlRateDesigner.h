@@ -0,0 +1,72 @@
+/*
+  ==============================================================================
+
+	ControlRateDesigner.h
+	Created: 16 Oct 2026 11:05:00pm
+	Author:  roeim
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "CoefficientDesign.h"
+#include "CoefficientService.h"
+#include "ParameterSnapshot.h"
+
+/*
+Hands the chain new coefficients once per control tick, without designing any on the audio thread.
+
+The CoefficientService designs a whole set on its own thread whenever a parameter moves. Each tick
+picks up the newest one and glides towards it over rampSeconds by interpolating the coefficients
+themselves, which is a few multiply-adds for each section that actually differs and nothing for the
+rest. A biquad is stable inside a triangle of (a1, a2), so the straight line between two stable
+sections stays stable all the way. The SVF's g and the bells' k and m1 glide the same way.
+
+What can't be interpolated switches on the tick: the slopes, the topology, the oversampling factor,
+the processing mode and a peak being switched on or off. Ticks fall on a fixed grid of samples,
+not on host block boundaries.
+
+Which tick a live change lands on depends on when the designer gets to it. Offline renders design
+on the tick instead, where CPU spikes don't matter, so the output doesn't depend on the block size.
+No locks, no allocation.
+*/
+class ControlRateDesigner {
+public:
+	ControlRateDesigner(const ParameterSnapshot &parameters);
+
+	/** Designs for the current parameter values and starts following them. Not real-time safe. */
+	void prepare(double sampleRate, int samplesPerTick);
+
+	/** Stops following the parameters until the next prepare(). Not real-time safe. */
+	void release();
+
+	/**
+	Advances one tick. Returns the updated set if anything changed, nullptr otherwise.
+	With designOnTick set, changes are designed right here instead of on the designer thread.
+	*/
+	const CoefficientSet *tick(bool designOnTick);
+
+private:
+	static constexpr double rampSeconds = 0.02;
+
+	const ParameterSnapshot &parameters;
+	CoefficientService service;
+
+	double sampleRate{ 44100.0 };
+	juce::uint32 seenVersion{ 0 };
+
+	// The ramp runs from `from` to `target`; `coefficients` is where it is now.
+	CoefficientSet from, target, coefficients;
+	int rampTicks{ 1 }, ticksLeft{ 0 };
+
+	bool lowCutMoving{ false }, highCutMoving{ false };
+	std::array<bool, maxPeakBands> peakMoving{};
+
+	bool needsUpdate{ true };
+
+	/** Starts gliding towards next. Returns true if anything had to switch straight away. */
+	bool startRamp(const CoefficientSet &next);
+	void interpolate(double proportion);
+};
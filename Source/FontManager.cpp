@@ -11,17 +11,58 @@
 #include <JuceHeader.h>
 #include "FontManager.h"
 
-juce::Font FontManager::inter(float size, Weight weight) {
-	auto [fontData, fontSize] = variableFont(weight);
+JUCE_IMPLEMENT_SINGLETON(FontManager::TypefaceRegistry)
+
+FontManager::TypefaceRegistry::~TypefaceRegistry() {
+	clearSingletonInstance();
+}
+
+juce::Typeface::Ptr FontManager::TypefaceRegistry::get(Weight weight) {
+	const juce::ScopedLock sl(lock);
+
+	auto &typeface = weight == bold ? boldTypeface : regularTypeface;
+
+	if (typeface == nullptr) {
+		auto [fontData, fontSize] = variableFont(weight);
+
+		// BinaryData lives as long as the process does, so there's nothing to copy or keep alive here.
+		typeface = juce::Typeface::createSystemTypefaceFor(fontData, static_cast<size_t>(fontSize));
+	}
+
+	return typeface;
+}
 
-	// COPY the data to a heap-allocated buffer
-	std::unique_ptr<char[]> fontCopy(new char[fontSize]);
-	std::memcpy(fontCopy.get(), fontData, fontSize);
+void FontManager::TypefaceRegistry::prewarm(const juce::String &characters) {
+	const juce::ScopedLock sl(lock);
 
-	auto typeface = juce::Typeface::createSystemTypefaceFor(fontCopy.get(), fontSize);
-	fontCopy.release(); // JUCE will now own this memory
+	// Nothing new to load. Also true for an empty string.
+	if (characters.containsOnly(prewarmedCharacters))
+		return;
 
-	juce::Font font(typeface);
+	for (auto weight : { regular, bold }) {
+		juce::Font font(get(weight));
+
+		// Laying the text out and flattening it forces the typeface to load every glyph outline.
+		juce::GlyphArrangement glyphs;
+		glyphs.addLineOfText(font, characters, 0.f, 0.f);
+
+		juce::Path outlines;
+		glyphs.createPath(outlines);
+	}
+
+	prewarmedCharacters << characters;
+}
+
+juce::Font FontManager::inter(float size, Weight weight) {
+	juce::Font font(getTypeface(weight));
 	font.setHeight(size);
 	return font;
-}
\ No newline at end of file
+}
+
+juce::Typeface::Ptr FontManager::getTypeface(Weight weight) {
+	return TypefaceRegistry::getInstance()->get(weight);
+}
+
+void FontManager::prewarm(const juce::String &characters) {
+	TypefaceRegistry::getInstance()->prewarm(characters);
+}
@@ -11,6 +11,7 @@
 #pragma once
 
 #include <JuceHeader.h>
+#include "BinaryData.h"
 
 //==============================================================================
 /*
@@ -35,5 +36,31 @@ struct FontManager {
 
 	}
 
+	/** Cheap: the typeface behind it is parsed once per process and shared. */
 	static juce::Font inter(float size, Weight weight);
+
+	/** The shared typeface for a weight. Thread safe. */
+	static juce::Typeface::Ptr getTypeface(Weight weight);
+
+	/** Parses both weights and loads the outlines of the given characters, so the first paint doesn't have to. */
+	static void prewarm(const juce::String &characters);
+
+private:
+	/*
+	Process-wide cache of the parsed Inter typefaces, shared by every plugin instance and editor.
+	Lives until JUCE shuts down, like JUCE's own typeface cache.
+	*/
+	struct TypefaceRegistry: private juce::DeletedAtShutdown {
+		~TypefaceRegistry() override;
+
+		juce::Typeface::Ptr get(Weight weight);
+		void prewarm(const juce::String &characters);
+
+		JUCE_DECLARE_SINGLETON(TypefaceRegistry, false)
+
+	private:
+		juce::CriticalSection lock;
+		juce::Typeface::Ptr regularTypeface, boldTypeface;
+		juce::String prewarmedCharacters;
+	};
 };
\ No newline at end of file
@@ -0,0 +1,408 @@
+/*
+  ==============================================================================
+
+	LinearPhaseEngine.cpp
+	Created: 17 Oct 2026 12:10:00am
+	Author:  roeim
+
+  ==============================================================================
+*/
+
+#include "LinearPhaseEngine.h"
+
+namespace {
+	int log2Of(int powerOfTwo) {
+		int order = 0;
+		while ((1 << order) < powerOfTwo)
+			++order;
+
+		return order;
+	}
+}
+
+LinearPhaseEngine::LinearPhaseEngine(const ParameterSnapshot &snapshot): parameters(snapshot) {
+	startTimer(housekeepingIntervalMs);
+}
+
+LinearPhaseEngine::~LinearPhaseEngine() {
+	stopTimer();
+	release();
+}
+
+void LinearPhaseEngine::prepare(double newSampleRate, int newNumChannels, bool activate) {
+	release();
+
+	sampleRate = newSampleRate;
+	numChannels = newNumChannels;
+
+	// About 170 ms of FIR, so a 20 Hz cut still has a few bins to work with at any rate.
+	firLength = juce::nextPowerOfTwo(juce::roundToInt(sampleRate / 6.0));
+
+	// The head costs partitionSize multiplies per sample and the tail about four per partition,
+	// so the two balance out around sqrt(2 * firLength).
+	partitionSize = juce::nextPowerOfTwo(juce::roundToInt(std::sqrt(2.0 * firLength)));
+	numPartitions = firLength / partitionSize - 1;
+
+	// Bins 0 to partitionSize of a 2 * partitionSize point real FFT, as interleaved complex pairs.
+	spectrumSize = 2 * (partitionSize + 1);
+
+	fadeLength = fadePartitions * partitionSize;
+
+	if (!activate)
+		return;
+
+	build();
+	reset();
+	state.store(Active);
+
+	designer = std::make_unique<DesignerThread>(*this);
+	designer->startThread(juce::Thread::Priority::low);
+}
+
+void LinearPhaseEngine::release() {
+	designer.reset();
+	freeBuffers();
+	state.store(Idle);
+}
+
+bool LinearPhaseEngine::update(bool wanted) {
+	auto current = state.load(std::memory_order_acquire);
+
+	if (!wanted) {
+		// A build that's still running finishes as Ready, and the next call lets go of it then.
+		if (current == Requested || current == Ready || current == Active)
+			state.compare_exchange_strong(current, Idle);
+
+		return false;
+	}
+
+	if (current == Active)
+		return true;
+
+	if (current == Ready && state.compare_exchange_strong(current, Active)) {
+		reset();
+		return true;
+	}
+
+	if (current == Idle)
+		state.compare_exchange_strong(current, Requested);
+
+	return false;
+}
+
+void LinearPhaseEngine::timerCallback() {
+	auto current = state.load(std::memory_order_acquire);
+
+	// The audio thread has let go, so whatever is left of the last session goes, even if it already wants a new one.
+	if (designer != nullptr && (current == Idle || current == Requested)) {
+		designer.reset();
+		freeBuffers();
+	}
+
+	// The designer builds, so neither this thread nor the audio thread waits on it.
+	auto requested = static_cast<int>(Requested);
+	if (state.compare_exchange_strong(requested, Building)) {
+		designer = std::make_unique<DesignerThread>(*this);
+		designer->startThread(juce::Thread::Priority::low);
+	}
+}
+
+void LinearPhaseEngine::build() {
+	partitionFFT = std::make_unique<juce::dsp::FFT>(log2Of(2 * partitionSize));
+	designPartitionFFT = std::make_unique<juce::dsp::FFT>(log2Of(2 * partitionSize));
+	firFFT = std::make_unique<juce::dsp::FFT>(log2Of(firLength));
+
+	fftScratch.assign(static_cast<size_t>(4 * partitionSize), 0.f);
+	accumulator.assign(static_cast<size_t>(spectrumSize), 0.f);
+	designSpectrum.assign(static_cast<size_t>(2 * firLength), 0.f);
+	designScratch.assign(static_cast<size_t>(4 * partitionSize), 0.f);
+
+	designWindow.resize(static_cast<size_t>(firLength - 1));
+	juce::dsp::WindowingFunction<float>::fillWindowingTables(designWindow.data(), designWindow.size(),
+															  juce::dsp::WindowingFunction<float>::blackman, false);
+
+	for (auto &kernel : kernels) {
+		kernel.head.assign(static_cast<size_t>(partitionSize), 0.f);
+		kernel.spectra.assign(static_cast<size_t>(numPartitions * spectrumSize), 0.f);
+	}
+
+	channels.resize(static_cast<size_t>(numChannels));
+	for (auto &channel : channels) {
+		channel.timeline.assign(static_cast<size_t>(2 * partitionSize), 0.f);
+		channel.delayLine.assign(static_cast<size_t>(numPartitions * spectrumSize), 0.f);
+		channel.tail.assign(static_cast<size_t>(partitionSize), 0.f);
+		channel.previousTail.assign(static_cast<size_t>(partitionSize), 0.f);
+	}
+
+	// The first kernel goes straight into slot 0, so there's something to run before the designer's loop gets going.
+	seenVersion = parameters.getVersion();
+	designKernel(parameters.load(), kernels[0]);
+	slots.store(Slots::pack(0, Slots::none, Slots::none));
+	fading = false;
+}
+
+void LinearPhaseEngine::freeBuffers() {
+	partitionFFT.reset();
+	designPartitionFFT.reset();
+	firFFT.reset();
+
+	// clear() keeps the capacity, and the point is to give the memory back.
+	std::vector<float>().swap(fftScratch);
+	std::vector<float>().swap(accumulator);
+	std::vector<float>().swap(designSpectrum);
+	std::vector<float>().swap(designScratch);
+	std::vector<float>().swap(designWindow);
+
+	for (auto &kernel : kernels)
+		kernel = {};
+
+	std::vector<ChannelState>().swap(channels);
+}
+
+void LinearPhaseEngine::reset() {
+	for (auto &channel : channels) {
+		std::fill(channel.timeline.begin(), channel.timeline.end(), 0.f);
+		std::fill(channel.tail.begin(), channel.tail.end(), 0.f);
+		std::fill(channel.previousTail.begin(), channel.previousTail.end(), 0.f);
+	}
+
+	// The delay line isn't cleared: partitions older than the reset are simply left out of the sum
+	// until new input has replaced them, which saves wiping megabytes on wide buses.
+	fill = 0;
+	fdlPosition = 0;
+	validPartitions = 0;
+}
+
+//==============================================================================
+void LinearPhaseEngine::designKernel(const ChainSettings &chainSettings, Kernel &kernel) {
+	// The whole curve at the host rate: linear phase has no use for oversampling.
+	auto settings = chainSettings;
+	settings.oversamplingOrder = 0;
+
+	const auto coefficients = designCoefficients(settings, sampleRate);
+
+	// The magnitude at every bin, with a delay of half the FIR, i.e. a sign flip on every odd bin.
+	std::fill(designSpectrum.begin(), designSpectrum.end(), 0.f);
+
+	for (int bin = 0; bin <= firLength / 2; ++bin) {
+		const auto s = juce::square(std::sin(juce::MathConstants<double>::pi * bin / firLength));
+
+		auto powerRatio = getMagnitudeSquared(coefficients.lowCut.data(), coefficients.numLowCutStages, s);
+
+		for (size_t band = 0; band < coefficients.peaks.size(); ++band)
+			if (coefficients.peakEnabled[band])
+				powerRatio *= getMagnitudeSquared(&coefficients.peaks[band], 1, s);
+
+		powerRatio *= getMagnitudeSquared(coefficients.highCut.data(), coefficients.numHighCutStages, s);
+
+		const auto magnitude = std::sqrt(juce::jmax(0.0, powerRatio));
+		designSpectrum[static_cast<size_t>(2 * bin)] = static_cast<float>((bin & 1) != 0 ? -magnitude : magnitude);
+	}
+
+	firFFT->performRealOnlyInverseTransform(designSpectrum.data());
+
+	// Symmetric around firLength / 2. Tap 0 has no partner, so it's dropped and the rest are windowed.
+	auto *taps = designSpectrum.data();
+	taps[0] = 0.f;
+	juce::FloatVectorOperations::multiply(taps + 1, designWindow.data(), firLength - 1);
+
+	for (int i = 0; i < partitionSize; ++i)
+		kernel.head[static_cast<size_t>(i)] = taps[partitionSize - 1 - i];
+
+	// Every later partition zero-padded to the FFT size, as overlap-save needs it.
+	for (int p = 0; p < numPartitions; ++p) {
+		std::fill(designScratch.begin(), designScratch.end(), 0.f);
+		std::copy(taps + (p + 1) * partitionSize, taps + (p + 2) * partitionSize, designScratch.begin());
+
+		designPartitionFFT->performRealOnlyForwardTransform(designScratch.data(), true);
+		std::copy(designScratch.begin(), designScratch.begin() + spectrumSize, kernel.spectra.begin() + p * spectrumSize);
+	}
+}
+
+bool LinearPhaseEngine::publishKernel(const ChainSettings &chainSettings) {
+	// Only this thread ever sets pending, and the audio thread never touches a slot it isn't told about,
+	// so a slot that's none of the three stays free until we publish it.
+	auto packed = slots.load(std::memory_order_acquire);
+
+	uint32_t slot = 0;
+	while (slot < 3 && (slot == Slots::current(packed) || slot == Slots::previous(packed) || slot == Slots::pending(packed)))
+		++slot;
+
+	if (slot == 3)
+		return false;
+
+	designKernel(chainSettings, kernels[slot]);
+
+	// Anything still pending is superseded, and becomes free again.
+	while (!slots.compare_exchange_weak(packed, Slots::pack(Slots::current(packed), Slots::previous(packed), slot),
+										std::memory_order_acq_rel)) {}
+
+	return true;
+}
+
+LinearPhaseEngine::DesignerThread::DesignerThread(LinearPhaseEngine &owner):
+	juce::Thread("SimpleEQ Linear Phase Designer"),
+	engine(owner) {}
+
+LinearPhaseEngine::DesignerThread::~DesignerThread() {
+	stopThread(1000);
+}
+
+void LinearPhaseEngine::DesignerThread::run() {
+	// Started by a switch to linear phase rather than by prepare(), so everything still has to be built.
+	if (engine.state.load(std::memory_order_acquire) == Building) {
+		engine.build();
+		engine.state.store(Ready, std::memory_order_release);
+	}
+
+	ChainSettings settings;
+	bool designPending = false;
+
+	// It only runs while the mode is on, so every change matters.
+	while (!threadShouldExit()) {
+		if (engine.parameters.loadIfChanged(settings, engine.seenVersion))
+			designPending = true;
+
+		// Every slot is busy while a fade is still running and another kernel waits behind it.
+		// Trying again on the next poll picks up whatever the parameters are by then.
+		if (designPending && engine.publishKernel(settings))
+			designPending = false;
+
+		wait(pollIntervalMs);
+	}
+}
+
+//==============================================================================
+bool LinearPhaseEngine::takePendingKernel() {
+	auto packed = slots.load(std::memory_order_acquire);
+
+	do {
+		if (Slots::pending(packed) == Slots::none)
+			return false;
+	} while (!slots.compare_exchange_weak(packed, Slots::pack(Slots::pending(packed), Slots::current(packed), Slots::none),
+										  std::memory_order_acq_rel));
+
+	fading = true;
+	fadePosition = 0;
+	return true;
+}
+
+void LinearPhaseEngine::finishFade() {
+	auto packed = slots.load(std::memory_order_acquire);
+
+	while (!slots.compare_exchange_weak(packed, Slots::pack(Slots::current(packed), Slots::none, Slots::pending(packed)),
+										std::memory_order_acq_rel)) {}
+
+	fading = false;
+}
+
+void LinearPhaseEngine::computeTail(const Kernel &kernel, const ChannelState &channel, std::vector<float> &tail) {
+	std::fill(accumulator.begin(), accumulator.end(), 0.f);
+
+	// Partition p of the kernel meets the input from p partitions ago.
+	for (int p = 0; p < validPartitions; ++p) {
+		const int slot = (fdlPosition - p + numPartitions) % numPartitions;
+
+		const auto *x = channel.delayLine.data() + slot * spectrumSize;
+		const auto *h = kernel.spectra.data() + p * spectrumSize;
+		auto *acc = accumulator.data();
+
+		for (int i = 0; i < spectrumSize; i += 2) {
+			acc[i] += x[i] * h[i] - x[i + 1] * h[i + 1];
+			acc[i + 1] += x[i] * h[i + 1] + x[i + 1] * h[i];
+		}
+	}
+
+	std::copy(accumulator.begin(), accumulator.end(), fftScratch.begin());
+	partitionFFT->performRealOnlyInverseTransform(fftScratch.data());
+
+	// Overlap-save: only the second half is free of wrap-around.
+	std::copy(fftScratch.begin() + partitionSize, fftScratch.begin() + 2 * partitionSize, tail.begin());
+}
+
+void LinearPhaseEngine::completePartition() {
+	for (auto &channel : channels) {
+		std::fill(fftScratch.begin(), fftScratch.end(), 0.f);
+		std::copy(channel.timeline.begin(), channel.timeline.end(), fftScratch.begin());
+
+		partitionFFT->performRealOnlyForwardTransform(fftScratch.data(), true);
+		std::copy(fftScratch.begin(), fftScratch.begin() + spectrumSize, channel.delayLine.begin() + fdlPosition * spectrumSize);
+
+		std::copy(channel.timeline.begin() + partitionSize, channel.timeline.end(), channel.timeline.begin());
+	}
+
+	validPartitions = juce::jmin(validPartitions + 1, numPartitions);
+
+	// Kernels only change at partition boundaries, where both tails can be computed from the same input.
+	if (!fading)
+		takePendingKernel();
+
+	const auto packed = slots.load(std::memory_order_relaxed);
+
+	for (auto &channel : channels) {
+		computeTail(kernels[Slots::current(packed)], channel, channel.tail);
+
+		if (fading)
+			computeTail(kernels[Slots::previous(packed)], channel, channel.previousTail);
+	}
+
+	fdlPosition = (fdlPosition + 1) % numPartitions;
+	fill = 0;
+}
+
+void LinearPhaseEngine::process(const juce::dsp::AudioBlock<float> &block) {
+	const int numChannels = juce::jmin(static_cast<int>(block.getNumChannels()), static_cast<int>(channels.size()));
+	const int numSamples = static_cast<int>(block.getNumSamples());
+
+	for (int start = 0; start < numSamples;) {
+		const int length = juce::jmin(partitionSize - fill, numSamples - start);
+		const auto packed = slots.load(std::memory_order_relaxed);
+
+		const auto &kernel = kernels[Slots::current(packed)];
+		const auto &outgoing = kernels[fading ? Slots::previous(packed) : Slots::current(packed)];
+
+		for (int ch = 0; ch < numChannels; ++ch) {
+			auto &channel = channels[static_cast<size_t>(ch)];
+			auto *data = block.getChannelPointer(static_cast<size_t>(ch)) + start;
+
+			std::copy(data, data + length, channel.timeline.begin() + partitionSize + fill);
+
+			for (int i = 0; i < length; ++i) {
+				// The head: the first partition's taps against the last partitionSize inputs.
+				const auto *history = channel.timeline.data() + fill + i + 1;
+
+				float y = 0.f;
+				for (int t = 0; t < partitionSize; ++t)
+					y += kernel.head[static_cast<size_t>(t)] * history[t];
+
+				y += channel.tail[static_cast<size_t>(fill + i)];
+
+				if (fading) {
+					float old = 0.f;
+					for (int t = 0; t < partitionSize; ++t)
+						old += outgoing.head[static_cast<size_t>(t)] * history[t];
+
+					old += channel.previousTail[static_cast<size_t>(fill + i)];
+
+					const auto gain = juce::jmin(1.f, static_cast<float>(fadePosition + i + 1) / static_cast<float>(fadeLength));
+					y = old + gain * (y - old);
+				}
+
+				data[i] = y;
+			}
+		}
+
+		if (fading) {
+			fadePosition += length;
+
+			if (fadePosition >= fadeLength)
+				finishFade();
+		}
+
+		fill += length;
+		start += length;
+
+		if (fill == partitionSize)
+			completePartition();
+	}
+}
@@ -0,0 +1,173 @@
+/*
+  ==============================================================================
+
+	LinearPhaseEngine.h
+	Created: 17 Oct 2026 12:10:00am
+	Author:  roeim
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+#include <atomic>
+#include <cstdint>
+
+#include "CoefficientDesign.h"
+#include "ParameterSnapshot.h"
+
+/*
+The chain's magnitude response with linear phase, as one long FIR.
+
+The FIR is synthesised from the same closed-form magnitude the response curve draws: sampled
+on an FFT grid, given a pure delay of half the FIR length, transformed back and windowed.
+The latency is exactly that delay.
+
+It runs as uniformly partitioned overlap-save convolution, with the first partition done
+directly in the time domain. That head covers the partition the FFT part would otherwise have
+to wait for, so the convolution adds no latency of its own on top of the FIR's delay.
+
+A background thread redesigns the FIR when the parameters change and hands it over without
+locks. The audio thread crossfades from the old kernel to the new one, running both tails off
+the same frequency-domain delay line while the fade lasts.
+
+While the mode is off, the engine holds no buffers and runs no thread. Switching it on only moves
+the state along; a timer on the message thread sees that and starts the designer, which allocates
+everything and designs the first kernel from the current settings. Only then does update() let the
+audio thread in, so the first thing it plays is the right curve. Switching off hands everything
+back to the message thread to free the same way, so the audio thread never posts a message.
+*/
+class LinearPhaseEngine: private juce::Timer {
+public:
+	LinearPhaseEngine(const ParameterSnapshot &parameters);
+	~LinearPhaseEngine() override;
+
+	/**
+	Works out the sizes for this rate and drops whatever was built for the last one. With activate set,
+	it also builds everything and designs the first kernel right here, so process() can run
+	straight away. Not real-time safe.
+	*/
+	void prepare(double sampleRate, int numChannels, bool activate);
+
+	/** Stops the designer and frees everything. Not real-time safe. */
+	void release();
+
+	/**
+	Audio thread, once per control period: whether the linear phase mode is wanted. Returns true if
+	process() may run. When the mode is switched on, that's only once the first kernel is ready,
+	and the history starts from silence. Real-time safe.
+	*/
+	bool update(bool wanted);
+
+	/** The FIR's delay, in samples. */
+	int getLatencySamples() const { return firLength / 2; }
+
+	/** Filters every channel of the block in place. Only while update() says so. Real-time safe. */
+	void process(const juce::dsp::AudioBlock<float> &block);
+
+private:
+	/*
+	Who owns the buffers. The audio thread only touches them in Active, which only it enters and
+	leaves. The designer builds them in Building and hands them over as Ready. The message thread
+	frees them once the audio thread has let go, back in Idle or Requested.
+	*/
+	enum State {
+		Idle,
+		Requested,
+		Building,
+		Ready,
+		Active
+	};
+
+	struct Kernel {
+		// The first partition's taps, reversed, for the time domain head.
+		std::vector<float> head;
+
+		// The spectrum of every later partition, spectrumSize floats each, in the FFT's packed order.
+		std::vector<float> spectra;
+	};
+
+	struct ChannelState {
+		// The previous partition's input followed by the current one's.
+		std::vector<float> timeline;
+
+		// The last numPartitions input spectra, newest at fdlPosition.
+		std::vector<float> delayLine;
+
+		// The tail's output for the partition being filled, for the current and the outgoing kernel.
+		std::vector<float> tail, previousTail;
+	};
+
+	/*
+	Which kernel slot is current, which one is fading out and which one is waiting to be picked up,
+	packed into one atomic, two bits each, so both threads always see a consistent set.
+	*/
+	struct Slots {
+		static constexpr uint32_t none = 3;
+
+		static uint32_t pack(uint32_t current, uint32_t previous, uint32_t pending) { return current | previous << 2 | pending << 4; }
+		static uint32_t current(uint32_t packed) { return packed & 3; }
+		static uint32_t previous(uint32_t packed) { return packed >> 2 & 3; }
+		static uint32_t pending(uint32_t packed) { return packed >> 4 & 3; }
+	};
+
+	struct DesignerThread: juce::Thread {
+		DesignerThread(LinearPhaseEngine &owner);
+		~DesignerThread() override;
+
+		void run() override;
+
+		LinearPhaseEngine &engine;
+	};
+
+	static constexpr int pollIntervalMs = 10;
+	static constexpr int housekeepingIntervalMs = 50;
+	static constexpr int fadePartitions = 4;
+
+	const ParameterSnapshot &parameters;
+	juce::uint32 seenVersion{ 0 };
+
+	std::atomic<int> state{ Idle };
+
+	double sampleRate{ 44100.0 };
+	int numChannels{ 0 };
+	int firLength{ 0 }, partitionSize{ 0 }, spectrumSize{ 0 }, numPartitions{ 0 };
+
+	// Audio thread.
+	std::unique_ptr<juce::dsp::FFT> partitionFFT;
+	std::vector<ChannelState> channels;
+	std::vector<float> fftScratch, accumulator;
+	int fill{ 0 }, fdlPosition{ 0 }, validPartitions{ 0 };
+	int fadePosition{ 0 }, fadeLength{ 0 };
+	bool fading{ false };
+
+	std::array<Kernel, 3> kernels;
+	std::atomic<uint32_t> slots{ Slots::pack(0, Slots::none, Slots::none) };
+
+	// Designer thread, and prepare() before it starts.
+	std::unique_ptr<juce::dsp::FFT> firFFT, designPartitionFFT;
+	std::vector<float> designSpectrum, designScratch, designWindow;
+
+	// Message thread.
+	std::unique_ptr<DesignerThread> designer;
+
+	/** Starts the designer once the audio thread asks for it, and frees everything once it lets go. */
+	void timerCallback() override;
+
+	/** Allocates every buffer and designs the first kernel from the current settings. Not real-time safe. */
+	void build();
+	void freeBuffers();
+	void reset();
+
+	void designKernel(const ChainSettings &chainSettings, Kernel &kernel);
+	bool publishKernel(const ChainSettings &chainSettings);
+
+	void completePartition();
+	void computeTail(const Kernel &kernel, const ChannelState &channel, std::vector<float> &tail);
+	bool takePendingKernel();
+	void finishFade();
+
+	JUCE_DECLARE_NON_COPYABLE(LinearPhaseEngine)
+};
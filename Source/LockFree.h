@@ -0,0 +1,135 @@
+/*
+  ==============================================================================
+
+	LockFree.h
+	Created: 16 Oct 2026 7:40:00pm
+	Author:  roeim
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+/**
+Single-producer / single-consumer handoff of the most recent value.
+
+The producer fills getWriteBuffer() and calls publish(), the consumer calls
+acquire() and reads getReadBuffer(). Both sides are wait-free: every call is a
+single atomic exchange, nothing blocks and nothing allocates. Values the
+consumer didn't get to in time are simply overwritten by newer ones.
+*/
+template<typename T>
+struct TripleBuffer {
+	/** Producer side: the slot to fill before calling publish(). */
+	T &getWriteBuffer() { return buffers[writeIndex]; }
+
+	/** Producer side: hands the write slot over to the consumer. */
+	void publish() {
+		auto previous = middle.exchange(writeIndex | newDataFlag, std::memory_order_acq_rel);
+		writeIndex = previous & indexMask;
+	}
+
+	/** Consumer side: returns true if a newer value was published since the last call. */
+	bool acquire() {
+		if ((middle.load(std::memory_order_relaxed) & newDataFlag) == 0)
+			return false;
+
+		auto previous = middle.exchange(readIndex, std::memory_order_acq_rel);
+		readIndex = previous & indexMask;
+		return true;
+	}
+
+	/** Consumer side: the value obtained by the last successful acquire(). */
+	const T &getReadBuffer() const { return buffers[readIndex]; }
+
+private:
+	static constexpr int indexMask = 3;
+	static constexpr int newDataFlag = 4;
+
+	std::array<T, 3> buffers;
+	int writeIndex = 0;
+	int readIndex = 1;
+	std::atomic<int> middle{ 2 };
+};
+
+/**
+Single-producer / single-consumer ring of raw samples, addressed by a running sample position.
+
+The producer pushes whole blocks with at most two memcpys and never waits on the consumer.
+The consumer reads any span it likes, at whatever hop size it likes, by position. If it falls
+so far behind that the producer has lapped it, read() says so and the consumer skips ahead.
+Nothing here depends on the size of the blocks being pushed.
+*/
+struct SampleRing {
+	/** Allocates the storage. Not real-time safe. capacity is rounded up to a power of two. */
+	void prepare(int capacity) {
+		int size = 1;
+		while (size < capacity)
+			size <<= 1;
+
+		samples.assign(static_cast<size_t>(size), 0.f);
+		mask = size - 1;
+		maxChunk = size / 4;
+	}
+
+	int getCapacity() const { return static_cast<int>(samples.size()); }
+
+	/** Producer side. Wait-free, no allocation. */
+	void push(const float *source, int numSamples) {
+		while (numSamples > 0) {
+			// Big blocks go in chunks, so a reader only ever has to stay clear of one chunk in flight.
+			const int chunk = numSamples < maxChunk ? numSamples : maxChunk;
+			const auto start = writePosition.load(std::memory_order_relaxed);
+
+			reservedPosition.store(start + chunk, std::memory_order_relaxed);
+			std::atomic_thread_fence(std::memory_order_release);
+
+			const int index = static_cast<int>(start & mask);
+			const int firstPart = chunk < getCapacity() - index ? chunk : getCapacity() - index;
+
+			std::memcpy(samples.data() + index, source, sizeof(float) * static_cast<size_t>(firstPart));
+			std::memcpy(samples.data(), source + firstPart, sizeof(float) * static_cast<size_t>(chunk - firstPart));
+
+			writePosition.store(start + chunk, std::memory_order_release);
+
+			source += chunk;
+			numSamples -= chunk;
+		}
+	}
+
+	/** The position one past the newest sample that can be read. */
+	int64_t getWritePosition() const { return writePosition.load(std::memory_order_acquire); }
+
+	/**
+	Consumer side. Copies the numSamples starting at position into dest.
+	Returns false if those samples haven't been written yet, or were overwritten while copying.
+	*/
+	bool read(int64_t position, float *dest, int numSamples) const {
+		if (position < 0 || position + numSamples > getWritePosition())
+			return false;
+
+		const int index = static_cast<int>(position & mask);
+		const int firstPart = numSamples < getCapacity() - index ? numSamples : getCapacity() - index;
+
+		std::memcpy(dest, samples.data() + index, sizeof(float) * static_cast<size_t>(firstPart));
+		std::memcpy(dest + firstPart, samples.data(), sizeof(float) * static_cast<size_t>(numSamples - firstPart));
+
+		// If the producer got far enough to touch what we just copied, the copy may be torn.
+		std::atomic_thread_fence(std::memory_order_acquire);
+		return reservedPosition.load(std::memory_order_relaxed) - position <= getCapacity();
+	}
+
+private:
+	std::vector<float> samples;
+	int mask{ 0 };
+	int maxChunk{ 0 };
+
+	std::atomic<int64_t> writePosition{ 0 };
+	std::atomic<int64_t> reservedPosition{ 0 };
+};
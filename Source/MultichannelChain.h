@@ -0,0 +1,591 @@
+/*
+  ==============================================================================
+
+	MultichannelChain.h
+	Created: 16 Oct 2026 8:05:00pm
+	Author:  roeim
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+#include "CoefficientDesign.h"
+
+#include <utility>
+
+/** A biquad's coefficients, broadcast to every lane, since every channel shares them. */
+template<typename SampleType>
+struct SIMDBiquadCoefficients {
+	using SIMDSample = juce::dsp::SIMDRegister<SampleType>;
+
+	SIMDSample b0, b1, b2, a1, a2;
+
+	void set(const BiquadCoefficients &c) {
+		b0 = SIMDSample::expand(static_cast<SampleType>(c.b0));
+		b1 = SIMDSample::expand(static_cast<SampleType>(c.b1));
+		b2 = SIMDSample::expand(static_cast<SampleType>(c.b2));
+		a1 = SIMDSample::expand(static_cast<SampleType>(c.a1));
+		a2 = SIMDSample::expand(static_cast<SampleType>(c.a2));
+	}
+};
+
+/** The transposed direct form II state of one biquad, for a group of channels. */
+template<typename SampleType>
+struct SIMDBiquadState {
+	using SIMDSample = juce::dsp::SIMDRegister<SampleType>;
+
+	SIMDSample s1, s2;
+
+	void reset() {
+		s1 = SIMDSample::expand(SampleType(0));
+		s2 = SIMDSample::expand(SampleType(0));
+	}
+
+	SIMDSample processSample(const SIMDBiquadCoefficients<SampleType> &c, SIMDSample x) noexcept {
+		auto y = c.b0 * x + s1;
+		s1 = c.b1 * x - c.a1 * y + s2;
+		s2 = c.b2 * x - c.a2 * y;
+		return y;
+	}
+};
+
+/** A TPT state-variable filter's coefficients for one sample, derived from g and k. */
+template<typename SampleType>
+struct SIMDSVFCoefficients {
+	using SIMDSample = juce::dsp::SIMDRegister<SampleType>;
+
+	SIMDSample a1, a2, a3;
+
+	void set(SampleType g, SampleType k) {
+		const auto d = SampleType(1) / (SampleType(1) + g * (g + k));
+
+		a1 = SIMDSample::expand(d);
+		a2 = SIMDSample::expand(g * d);
+		a3 = SIMDSample::expand(g * g * d);
+	}
+};
+
+/*
+The two integrator states of a TPT state-variable filter, for a group of channels.
+Unlike a biquad's, they stay well behaved when the coefficients change on every sample.
+*/
+template<typename SampleType>
+struct SIMDSVFState {
+	using SIMDSample = juce::dsp::SIMDRegister<SampleType>;
+
+	SIMDSample ic1, ic2;
+
+	void reset() {
+		ic1 = SIMDSample::expand(SampleType(0));
+		ic2 = SIMDSample::expand(SampleType(0));
+	}
+
+	/** Runs x through the filter, leaving the band-pass output in v1 and the low-pass output in v2. */
+	void processSample(const SIMDSVFCoefficients<SampleType> &c, SIMDSample x, SIMDSample &v1, SIMDSample &v2) noexcept {
+		auto v3 = x - ic2;
+		v1 = c.a1 * ic1 + c.a2 * v3;
+		v2 = ic2 + c.a2 * ic1 + c.a3 * v3;
+		ic1 = v1 + v1 - ic1;
+		ic2 = v2 + v2 - ic2;
+	}
+};
+
+/*
+LowCut -> Peaks -> HighCut for any number of channels, as biquads or as smoothed SVFs.
+
+The coefficients are stored once. The filter state is stored per group of channelsPerGroup
+channels, one channel per SIMD lane, so a single instruction advances a whole group.
+Up to maxGroupsPerPass groups (16 channels with 4-wide registers) go through the cascade
+together: a filter is bound by the latency of its own feedback, so interleaving independent
+groups fills the gaps and doubling the channel count costs well under twice as much.
+
+The biquads jump to new coefficients once per setCoefficients(). The SVFs instead glide their
+g, k and m1 to the new targets over smoothingSeconds (or setSmoothingSamples()), one step per
+sample, so automation doesn't zipper. That costs a division and a few multiplies per section per
+sample, shared by every channel.
+
+There's one kernel for each (topology, lowCut stages, highCut stages, groups) combination. Each is
+straight-line code with exactly the sections that slope needs, and setCoefficients() and
+process() pick the right one from a table. The peak bands are a short loop over just the enabled
+ones, so a disabled band costs nothing per sample, and every band's state sits in one flat array.
+
+SampleType is float or double. The double chain packs half as many channels per register, but
+keeps very low cutoffs at high sample rates (48 dB/oct at 20 Hz and 192 kHz, say) accurate,
+where float biquads start to lose the poles to rounding.
+*/
+template<typename SampleType>
+struct MultichannelChain {
+	using SIMDSample = juce::dsp::SIMDRegister<SampleType>;
+
+	/** Channels that share one SIMD register, one per lane: half as many for double as for float. */
+	static constexpr int channelsPerGroup = static_cast<int>(SIMDSample::size());
+
+	static constexpr int maxCutStages = 4;
+	static constexpr int maxGroupsPerPass = 4;
+	static constexpr double smoothingSeconds = 0.02;
+
+	/** Allocates state for spec.numChannels and an interleave buffer for spec.maximumBlockSize. */
+	void prepare(const juce::dsp::ProcessSpec &spec) {
+		numChannels = static_cast<int>(spec.numChannels);
+		groups.resize(static_cast<size_t>((numChannels + channelsPerGroup - 1) / channelsPerGroup));
+
+		// Each pass gets its own interleave buffer, so passes can run on different threads.
+		const auto groupsPerPass = juce::jmin(static_cast<int>(groups.size()), maxGroupsPerPass);
+		numPasses = (static_cast<int>(groups.size()) + maxGroupsPerPass - 1) / maxGroupsPerPass;
+		blockCapacity = juce::jmax(1, static_cast<int>(spec.maximumBlockSize));
+		passCapacity = static_cast<size_t>(groupsPerPass * blockCapacity);
+		interleaved.resize(static_cast<size_t>(numPasses) * passCapacity);
+
+		smoothers.reset(juce::jmax(1, juce::roundToInt(spec.sampleRate * smoothingSeconds)));
+
+		reset();
+	}
+
+	/**
+	How many samples the SVFs take to reach new targets. When the caller already ramps the
+	parameters and sends coefficients at a fixed rate, set this to that period so the SVFs
+	interpolate between updates instead of smoothing a second time. Real-time safe.
+	*/
+	void setSmoothingSamples(int numSamples) {
+		smoothers.reset(juce::jmax(1, numSamples));
+		snapSmoothers = true;
+	}
+
+	void reset() {
+		for (auto &group : groups)
+			group.reset();
+
+		// Whatever comes next is where the SVFs start, not where they glide to.
+		snapSmoothers = true;
+	}
+
+	void setCoefficients(const CoefficientSet &coefficients) {
+		// Zero stages takes that cut out of the chain altogether.
+		jassert(juce::isPositiveAndNotGreaterThan(coefficients.numLowCutStages, maxCutStages));
+		jassert(juce::isPositiveAndNotGreaterThan(coefficients.numHighCutStages, maxCutStages));
+
+		// The other topology's state is stale, and the two don't map onto each other anyway.
+		if (coefficients.topology != topology)
+			reset();
+
+		// Stages that were switched off held on to whatever state they had, so start them from silence.
+		for (auto &group : groups) {
+			for (int i = numLowCutStages; i < coefficients.numLowCutStages; ++i) {
+				group.biquad.lowCut[i].reset();
+				group.svf.lowCut[i].reset();
+			}
+
+			for (int i = numHighCutStages; i < coefficients.numHighCutStages; ++i) {
+				group.biquad.highCut[i].reset();
+				group.svf.highCut[i].reset();
+			}
+
+			for (size_t band = 0; band < peakEnabled.size(); ++band) {
+				if (coefficients.peakEnabled[band] && !peakEnabled[band]) {
+					group.biquad.peaks[band].reset();
+					group.svf.peaks[band].reset();
+				}
+			}
+		}
+
+		for (int i = 0; i < maxCutStages; ++i) {
+			shared.lowCut[i].set(coefficients.lowCut[i]);
+			shared.highCut[i].set(coefficients.highCut[i]);
+		}
+
+		shared.numActivePeaks = 0;
+
+		for (size_t band = 0; band < peakEnabled.size(); ++band) {
+			if (!coefficients.peakEnabled[band])
+				continue;
+
+			shared.peaks[band].set(coefficients.peaks[band]);
+			shared.activePeaks[static_cast<size_t>(shared.numActivePeaks++)] = static_cast<int>(band);
+
+			// A band that was off has no glide to continue, so it starts right at its target.
+			smoothers.peaks[band].setTargets(coefficients.svf.peaks[band], snapSmoothers || !peakEnabled[band]);
+		}
+
+		for (int i = 0; i < maxCutStages; ++i) {
+			shared.lowCutK[i] = static_cast<SampleType>(coefficients.svf.lowCutK[i]);
+			shared.highCutK[i] = static_cast<SampleType>(coefficients.svf.highCutK[i]);
+		}
+
+		smoothers.setTargets(coefficients.svf, snapSmoothers);
+		snapSmoothers = false;
+
+		topology = coefficients.topology;
+		numLowCutStages = coefficients.numLowCutStages;
+		numHighCutStages = coefficients.numHighCutStages;
+		peakEnabled = coefficients.peakEnabled;
+
+		kernels = selectKernels(topology, numLowCutStages, numHighCutStages);
+	}
+
+	/** Filters every channel of the block in place. Real-time safe. */
+	void process(const juce::dsp::ProcessContextReplacing<SampleType> &context) {
+		beginBlock(static_cast<int>(context.getOutputBlock().getNumSamples()));
+
+		for (int pass = 0; pass < numPasses; ++pass)
+			processPass(context, pass);
+	}
+
+	/**
+	Call once per block before the processPass() calls for it. Moves the smoothing on by the
+	block, so every pass glides along the exact same path. Real-time safe.
+	*/
+	void beginBlock(int numSamples) {
+		blockStartSmoothers = smoothers;
+		smoothers.skip(numSamples);
+	}
+
+	/** How many independent passes process() takes, each over up to maxGroupsPerPass groups of channels. */
+	int getNumPasses() const { return numPasses; }
+
+	/**
+	Filters only the channels of one pass. Different passes touch disjoint channels, state and
+	scratch memory, so they may run concurrently on different threads. Real-time safe.
+	*/
+	void processPass(const juce::dsp::ProcessContextReplacing<SampleType> &context, int pass) {
+		auto &block = context.getOutputBlock();
+
+		const int channels = juce::jmin(static_cast<int>(block.getNumChannels()), numChannels);
+		const int numSamples = static_cast<int>(block.getNumSamples());
+		const int numGroups = (channels + channelsPerGroup - 1) / channelsPerGroup;
+
+		// More channels than we were prepared for means the host skipped prepareToPlay after a layout change.
+		jassert(static_cast<int>(block.getNumChannels()) <= numChannels);
+
+		const int firstGroup = pass * maxGroupsPerPass;
+		if (firstGroup >= numGroups)
+			return;
+
+		const int groupsInPass = juce::jmin(maxGroupsPerPass, numGroups - firstGroup);
+		auto *scratch = interleaved.data() + static_cast<size_t>(pass) * passCapacity;
+		auto passSmoothers = blockStartSmoothers;
+
+		// Hosts shouldn't exceed the block size they announced, but if one does we just take more passes.
+		for (int start = 0; start < numSamples; start += blockCapacity) {
+			const int length = juce::jmin(blockCapacity, numSamples - start);
+
+			interleave(block, channels, firstGroup, groupsInPass, start, length, scratch);
+			kernels[static_cast<size_t>(groupsInPass - 1)](shared, passSmoothers, groups.data() + firstGroup, scratch, static_cast<size_t>(length));
+			deinterleave(block, channels, firstGroup, groupsInPass, start, length, scratch);
+		}
+	}
+
+private:
+	struct Coefficients {
+		std::array<SIMDBiquadCoefficients<SampleType>, maxCutStages> lowCut, highCut;
+		std::array<SIMDBiquadCoefficients<SampleType>, maxPeakBands> peaks;
+
+		// The enabled bands, in order. Only these run.
+		std::array<int, maxPeakBands> activePeaks{};
+		int numActivePeaks{ 0 };
+
+		// The SVF cut sections' damping only changes with the slope, so it isn't smoothed.
+		std::array<SampleType, maxCutStages> lowCutK{}, highCutK{};
+	};
+
+	struct BellSmoothers {
+		juce::SmoothedValue<SampleType, juce::ValueSmoothingTypes::Multiplicative> g, k;
+		juce::SmoothedValue<SampleType> m1;
+
+		void reset(int numSteps) {
+			g.reset(numSteps);
+			k.reset(numSteps);
+			m1.reset(numSteps);
+		}
+
+		void setTargets(const SVFTargets::Bell &targets, bool snap) {
+			if (snap) {
+				g.setCurrentAndTargetValue(static_cast<SampleType>(targets.g));
+				k.setCurrentAndTargetValue(static_cast<SampleType>(targets.k));
+				m1.setCurrentAndTargetValue(static_cast<SampleType>(targets.m1));
+			} else {
+				g.setTargetValue(static_cast<SampleType>(targets.g));
+				k.setTargetValue(static_cast<SampleType>(targets.k));
+				m1.setTargetValue(static_cast<SampleType>(targets.m1));
+			}
+		}
+
+		void skip(int numSamples) {
+			g.skip(numSamples);
+			k.skip(numSamples);
+			m1.skip(numSamples);
+		}
+	};
+
+	struct Smoothers {
+		juce::SmoothedValue<SampleType, juce::ValueSmoothingTypes::Multiplicative> lowCutG, highCutG;
+		std::array<BellSmoothers, maxPeakBands> peaks;
+
+		void reset(int numSteps) {
+			lowCutG.reset(numSteps);
+			highCutG.reset(numSteps);
+
+			for (auto &peak : peaks)
+				peak.reset(numSteps);
+		}
+
+		/** The cuts only. Each enabled bell's targets are set on its own. */
+		void setTargets(const SVFTargets &targets, bool snap) {
+			if (snap) {
+				lowCutG.setCurrentAndTargetValue(static_cast<SampleType>(targets.lowCutG));
+				highCutG.setCurrentAndTargetValue(static_cast<SampleType>(targets.highCutG));
+			} else {
+				lowCutG.setTargetValue(static_cast<SampleType>(targets.lowCutG));
+				highCutG.setTargetValue(static_cast<SampleType>(targets.highCutG));
+			}
+		}
+
+		void skip(int numSamples) {
+			lowCutG.skip(numSamples);
+			highCutG.skip(numSamples);
+
+			for (auto &peak : peaks)
+				peak.skip(numSamples);
+		}
+	};
+
+	template<typename Section>
+	struct Sections {
+		std::array<Section, maxCutStages> lowCut, highCut;
+		std::array<Section, maxPeakBands> peaks;
+
+		void reset() {
+			for (auto &stage : lowCut)
+				stage.reset();
+
+			for (auto &peak : peaks)
+				peak.reset();
+
+			for (auto &stage : highCut)
+				stage.reset();
+		}
+	};
+
+	using BiquadSections = Sections<SIMDBiquadState<SampleType>>;
+	using SVFSections = Sections<SIMDSVFState<SampleType>>;
+
+	struct GroupState {
+		BiquadSections biquad;
+		SVFSections svf;
+
+		void reset() {
+			biquad.reset();
+			svf.reset();
+		}
+	};
+
+	using Kernel = void (*)(const Coefficients &, Smoothers &, GroupState *, SIMDSample *, size_t);
+	using KernelsByGroupCount = std::array<Kernel, maxGroupsPerPass>;
+
+	Coefficients shared;
+	Smoothers smoothers, blockStartSmoothers;
+	bool snapSmoothers{ true };
+
+	std::vector<GroupState> groups;
+
+	// One region per pass. Sample-major: the registers of every group in the pass for sample 0, then sample 1, ...
+	std::vector<SIMDSample> interleaved;
+	size_t passCapacity{ 0 };
+	int blockCapacity{ 0 };
+	int numChannels{ 0 };
+	int numPasses{ 0 };
+
+	Topology topology{ Topology_Biquad };
+	int numLowCutStages{ 1 }, numHighCutStages{ 1 };
+	std::array<bool, maxPeakBands> peakEnabled{};
+	KernelsByGroupCount kernels{ selectKernels(Topology_Biquad, 1, 1) };
+
+	template<size_t NumGroups, size_t... Stage>
+	static void processBiquadStages(const std::array<SIMDBiquadCoefficients<SampleType>, maxCutStages> &coefficients,
+									std::array<BiquadSections, NumGroups> &state,
+									std::array<SIMDBiquadState<SampleType>, maxCutStages> BiquadSections:: *stages,
+									std::array<SIMDSample, NumGroups> &x,
+									std::index_sequence<Stage...>) {
+		// Stage by stage, and within a stage group by group, so the independent recursions interleave.
+		([&] {
+			for (size_t g = 0; g < NumGroups; ++g)
+				x[g] = (state[g].*stages)[Stage].processSample(coefficients[Stage], x[g]);
+		}(), ...);
+	}
+
+	template<int NumLowCutStages, int NumHighCutStages, int NumGroups>
+	static void processBiquadKernel(const Coefficients &sharedCoefficients, Smoothers &, GroupState *groupStates,
+									SIMDSample *samples, size_t numSamples) {
+		// Work on local copies, so the compiler can keep everything in registers
+		// instead of assuming every write to samples might alias it.
+		const auto coefficients = sharedCoefficients;
+
+		std::array<BiquadSections, NumGroups> state;
+		for (size_t g = 0; g < NumGroups; ++g)
+			state[g] = groupStates[g].biquad;
+
+		for (size_t i = 0; i < numSamples; ++i) {
+			auto *frame = samples + i * NumGroups;
+
+			std::array<SIMDSample, NumGroups> x;
+			std::copy(frame, frame + NumGroups, x.begin());
+
+			processBiquadStages(coefficients.lowCut, state, &BiquadSections::lowCut, x, std::make_index_sequence<NumLowCutStages>());
+
+			for (int n = 0; n < coefficients.numActivePeaks; ++n) {
+				const auto band = static_cast<size_t>(coefficients.activePeaks[static_cast<size_t>(n)]);
+
+				for (size_t g = 0; g < NumGroups; ++g)
+					x[g] = state[g].peaks[band].processSample(coefficients.peaks[band], x[g]);
+			}
+
+			processBiquadStages(coefficients.highCut, state, &BiquadSections::highCut, x, std::make_index_sequence<NumHighCutStages>());
+
+			std::copy(x.begin(), x.end(), frame);
+		}
+
+		for (size_t g = 0; g < NumGroups; ++g)
+			groupStates[g].biquad = state[g];
+	}
+
+	template<bool HighPass, size_t NumGroups, size_t... Stage>
+	static void processSVFStages(const std::array<SampleType, maxCutStages> &damping, SampleType g,
+								 std::array<SVFSections, NumGroups> &state,
+								 std::array<SIMDSVFState<SampleType>, maxCutStages> SVFSections:: *stages,
+								 std::array<SIMDSample, NumGroups> &x,
+								 std::index_sequence<Stage...>) {
+		([&] {
+			SIMDSVFCoefficients<SampleType> c;
+			c.set(g, damping[Stage]);
+
+			const auto k = SIMDSample::expand(damping[Stage]);
+
+			for (size_t group = 0; group < NumGroups; ++group) {
+				SIMDSample v1, v2;
+				(state[group].*stages)[Stage].processSample(c, x[group], v1, v2);
+
+				if constexpr (HighPass)
+					x[group] = x[group] - k * v1 - v2;
+				else
+					x[group] = v2;
+			}
+		}(), ...);
+	}
+
+	template<int NumLowCutStages, int NumHighCutStages, int NumGroups>
+	static void processSVFKernel(const Coefficients &coefficients, Smoothers &smoothing, GroupState *groupStates,
+								 SIMDSample *samples, size_t numSamples) {
+		std::array<SVFSections, NumGroups> state;
+		for (size_t g = 0; g < NumGroups; ++g)
+			state[g] = groupStates[g].svf;
+
+		for (size_t i = 0; i < numSamples; ++i) {
+			auto *frame = samples + i * NumGroups;
+
+			std::array<SIMDSample, NumGroups> x;
+			std::copy(frame, frame + NumGroups, x.begin());
+
+			processSVFStages<true>(coefficients.lowCutK, smoothing.lowCutG.getNextValue(),
+								   state, &SVFSections::lowCut, x, std::make_index_sequence<NumLowCutStages>());
+
+			// Each bell: the input plus m1 times the band-pass output.
+			for (int n = 0; n < coefficients.numActivePeaks; ++n) {
+				const auto band = static_cast<size_t>(coefficients.activePeaks[static_cast<size_t>(n)]);
+				auto &bell = smoothing.peaks[band];
+
+				SIMDSVFCoefficients<SampleType> peak;
+				peak.set(bell.g.getNextValue(), bell.k.getNextValue());
+
+				const auto m1 = SIMDSample::expand(bell.m1.getNextValue());
+
+				for (size_t g = 0; g < NumGroups; ++g) {
+					SIMDSample v1, v2;
+					state[g].peaks[band].processSample(peak, x[g], v1, v2);
+					x[g] = x[g] + m1 * v1;
+				}
+			}
+
+			processSVFStages<false>(coefficients.highCutK, smoothing.highCutG.getNextValue(),
+									state, &SVFSections::highCut, x, std::make_index_sequence<NumHighCutStages>());
+
+			std::copy(x.begin(), x.end(), frame);
+		}
+
+		for (size_t g = 0; g < NumGroups; ++g)
+			groupStates[g].svf = state[g];
+	}
+
+	template<int TopologyIndex, int NumLowCutStages, int NumHighCutStages, int NumGroups>
+	static constexpr Kernel getKernel() {
+		if constexpr (TopologyIndex == Topology_SmoothedSVF)
+			return &processSVFKernel<NumLowCutStages, NumHighCutStages, NumGroups>;
+		else
+			return &processBiquadKernel<NumLowCutStages, NumHighCutStages, NumGroups>;
+	}
+
+	template<int TopologyIndex, int NumLowCutStages, int NumHighCutStages, size_t... GroupIndex>
+	static constexpr KernelsByGroupCount makeKernelsByGroupCount(std::index_sequence<GroupIndex...>) {
+		return { getKernel<TopologyIndex, NumLowCutStages, NumHighCutStages, static_cast<int>(GroupIndex) + 1>()... };
+	}
+
+	// Zero to maxCutStages sections per cut.
+	static constexpr int numStageCounts = maxCutStages + 1;
+	static constexpr int numKernelSets = 2 * numStageCounts * numStageCounts;
+
+	template<size_t... Index>
+	static constexpr std::array<KernelsByGroupCount, sizeof...(Index)> makeKernelTable(std::index_sequence<Index...>) {
+		return { makeKernelsByGroupCount<
+			static_cast<int>(Index) / (numStageCounts * numStageCounts),
+			static_cast<int>(Index) / numStageCounts % numStageCounts,
+			static_cast<int>(Index) % numStageCounts>(std::make_index_sequence<maxGroupsPerPass>())... };
+	}
+
+	static KernelsByGroupCount selectKernels(Topology topology, int numLowCutStages, int numHighCutStages);
+
+	/*
+	Copies length samples from the pass's channels (starting at startSample) into the lanes of scratch.
+	Lanes without a channel are zeroed so their filter state stays silent.
+	*/
+	static void interleave(const juce::dsp::AudioBlock<SampleType> &block, int channels, int firstGroup, int groupsInPass,
+						   int startSample, int length, SIMDSample *scratch) {
+		auto *out = reinterpret_cast<SampleType *>(scratch);
+		const int stride = groupsInPass * channelsPerGroup;
+
+		for (int lane = 0; lane < stride; ++lane) {
+			const int ch = firstGroup * channelsPerGroup + lane;
+
+			if (ch < channels) {
+				auto *in = block.getChannelPointer(static_cast<size_t>(ch)) + startSample;
+
+				for (int i = 0; i < length; ++i)
+					out[i * stride + lane] = in[i];
+			} else {
+				for (int i = 0; i < length; ++i)
+					out[i * stride + lane] = SampleType(0);
+			}
+		}
+	}
+
+	/** The reverse of interleave(). */
+	static void deinterleave(const juce::dsp::AudioBlock<SampleType> &block, int channels, int firstGroup, int groupsInPass,
+							 int startSample, int length, const SIMDSample *scratch) {
+		auto *in = reinterpret_cast<const SampleType *>(scratch);
+		const int stride = groupsInPass * channelsPerGroup;
+		const int lanesInUse = juce::jmin(stride, channels - firstGroup * channelsPerGroup);
+
+		for (int lane = 0; lane < lanesInUse; ++lane) {
+			auto *out = block.getChannelPointer(static_cast<size_t>(firstGroup * channelsPerGroup + lane)) + startSample;
+
+			for (int i = 0; i < length; ++i)
+				out[i] = in[i * stride + lane];
+		}
+	}
+};
+
+template<typename SampleType>
+typename MultichannelChain<SampleType>::KernelsByGroupCount MultichannelChain<SampleType>::selectKernels(Topology topology, int numLowCutStages, int numHighCutStages) {
+	static constexpr auto kernels = makeKernelTable(std::make_index_sequence<numKernelSets>());
+	return kernels[static_cast<size_t>((static_cast<int>(topology) * numStageCounts + numLowCutStages) * numStageCounts + numHighCutStages)];
+}
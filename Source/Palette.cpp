@@ -44,4 +44,7 @@ const Colour Palette::FFTBodyGradient2 = Colour(0x09B2B2BE);
 const Colour Palette::FFTBodyGradient3 = Colour(0x00B2B2BE);
 const Colour Palette::FFTOutlineGradient1 = Palette::TextColour;
 const Colour Palette::FFTOutlineGradient2= Colour(0x14ADADB9); 
-const Colour Palette::FFTOutlineGradient3 = Colour(0x05ADADB9);
\ No newline at end of file
+const Colour Palette::FFTOutlineGradient3 = Colour(0x05ADADB9);
+const Colour Palette::FFTRightOutline = Colour(0xFF8FB8FF);
+const Colour Palette::FFTMidOutline = Colour(0xFFFFD08A);
+const Colour Palette::FFTSideOutline = Colour(0xFFE39AF0);
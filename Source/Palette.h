@@ -46,4 +46,8 @@ struct Palette {
 	static const Colour FFTOutlineGradient1;
 	static const Colour FFTOutlineGradient2;
 	static const Colour FFTOutlineGradient3;
+	// The top of the outline for the other analyzer views. Left uses FFTOutlineGradient1.
+	static const Colour FFTRightOutline;
+	static const Colour FFTMidOutline;
+	static const Colour FFTSideOutline;
 };
\ No newline at end of file
@@ -0,0 +1,81 @@
+/*
+  ==============================================================================
+
+	ParameterSnapshot.cpp
+	Created: 16 Oct 2026 8:31:00pm
+	Author:  roeim
+
+  ==============================================================================
+*/
+
+#include "ParameterSnapshot.h"
+
+ParameterSnapshot::ParameterSnapshot(juce::AudioProcessorValueTreeState &state):
+	apvts(state),
+	lowCutFreq(getHandle<juce::AudioParameterFloat>("LowCut Freq")),
+	highCutFreq(getHandle<juce::AudioParameterFloat>("HighCut Freq")),
+	lowCutSlope(getHandle<juce::AudioParameterChoice>("LowCut Slope")),
+	highCutSlope(getHandle<juce::AudioParameterChoice>("HighCut Slope")),
+	topology(getHandle<juce::AudioParameterChoice>("Filter Topology")),
+	designMethod(getHandle<juce::AudioParameterChoice>("Filter Design")),
+	oversampling(getHandle<juce::AudioParameterChoice>("Oversampling")),
+	processingMode(getHandle<juce::AudioParameterChoice>("Processing Mode")) {
+	for (int band = 0; band < maxPeakBands; ++band) {
+		auto &handles = peaks[static_cast<size_t>(band)];
+		handles.freq = getHandle<juce::AudioParameterFloat>(getPeakParameterID(band, "Freq"));
+		handles.gain = getHandle<juce::AudioParameterFloat>(getPeakParameterID(band, "Gain"));
+		handles.quality = getHandle<juce::AudioParameterFloat>(getPeakParameterID(band, "Quality"));
+		handles.enabled = getHandle<juce::AudioParameterBool>(getPeakParameterID(band, "Enabled"));
+	}
+
+	for (auto *param : apvts.processor.getParameters())
+		param->addListener(this);
+}
+
+ParameterSnapshot::~ParameterSnapshot() {
+	for (auto *param : apvts.processor.getParameters())
+		param->removeListener(this);
+}
+
+juce::String getPeakParameterID(int band, const juce::String &name) {
+	return band == 0 ? "Peak " + name : "Peak " + juce::String(band + 1) + " " + name;
+}
+
+template<typename ParameterType>
+ParameterType *ParameterSnapshot::getHandle(const juce::String &parameterID) {
+	auto *handle = dynamic_cast<ParameterType *>(apvts.getParameter(parameterID));
+
+	// Either the ID is misspelled or the layout changed the parameter's type.
+	jassert(handle != nullptr);
+
+	return handle;
+}
+
+ChainSettings ParameterSnapshot::load() const {
+	ChainSettings settings;
+
+	settings.lowCutFreq = lowCutFreq->get();
+	settings.highCutFreq = highCutFreq->get();
+
+	for (size_t band = 0; band < peaks.size(); ++band) {
+		auto &peak = settings.peaks[band];
+		peak.freq = peaks[band].freq->get();
+		peak.gainInDecibels = peaks[band].gain->get();
+		peak.quality = peaks[band].quality->get();
+		peak.enabled = peaks[band].enabled->get();
+	}
+
+	settings.lowCutSlope = static_cast<Slope>(lowCutSlope->getIndex());
+	settings.highCutSlope = static_cast<Slope>(highCutSlope->getIndex());
+	settings.topology = static_cast<Topology>(topology->getIndex());
+	settings.designMethod = static_cast<DesignMethod>(designMethod->getIndex());
+	settings.oversamplingOrder = oversampling->getIndex();
+	settings.linearPhase = processingMode->getIndex() == 1;
+
+	return settings;
+}
+
+void ParameterSnapshot::parameterValueChanged(int parameterIndex, float newValue) {
+	juce::ignoreUnused(parameterIndex, newValue);
+	invalidate();
+}
@@ -0,0 +1,126 @@
+/*
+  ==============================================================================
+
+	ParameterSnapshot.h
+	Created: 16 Oct 2026 8:31:00pm
+	Author:  roeim
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+enum Slope {
+	Slope_12,
+	Slope_24,
+	Slope_36,
+	Slope_48
+};
+
+enum Topology {
+	Topology_Biquad,
+	Topology_SmoothedSVF
+};
+
+enum DesignMethod {
+	Design_Bilinear,
+	Design_MagnitudeMatched
+};
+
+// Parametric bands between the two cuts. Fixed, so every band's state can live in one flat array.
+constexpr int maxPeakBands = 8;
+
+struct PeakBandSettings {
+	float freq{ 0 }, gainInDecibels{ 0 }, quality{ 1.f };
+
+	// A disabled band is left out of the chain altogether rather than run flat.
+	bool enabled{ false };
+};
+
+struct ChainSettings {
+	std::array<PeakBandSettings, maxPeakBands> peaks;
+	float lowCutFreq{ 0 }, highCutFreq{ 0 };
+
+	Slope lowCutSlope{ Slope::Slope_12 }, highCutSlope{ Slope::Slope_12 };
+
+	Topology topology{ Topology_Biquad };
+	DesignMethod designMethod{ Design_Bilinear };
+
+	// One long linear phase FIR instead of the IIR chain. Topology and oversampling don't apply.
+	bool linearPhase{ false };
+
+	// The peaks and high cut run at 2^oversamplingOrder times the host rate. 0 means no oversampling.
+	int oversamplingOrder{ 0 };
+};
+
+/*
+The ID of one of a peak band's parameters, e.g. "Freq". The first band keeps the plain
+"Peak Freq" style IDs from before there were more, so older sessions still load into it.
+*/
+juce::String getPeakParameterID(int band, const juce::String &name);
+
+/*
+Typed handles to every parameter the DSP reads, looked up by ID once at construction.
+
+load() reads the parameters' atomics straight through the handles, so it never hashes a
+string or allocates and is fine on the audio thread. Every change bumps a version counter,
+so a reader can tell with a single atomic load whether anything moved since it last looked.
+*/
+class ParameterSnapshot: private juce::AudioProcessorParameter::Listener {
+public:
+	ParameterSnapshot(juce::AudioProcessorValueTreeState &apvts);
+	~ParameterSnapshot() override;
+
+	/** Changes whenever any parameter does. */
+	juce::uint32 getVersion() const { return version.load(std::memory_order_acquire); }
+
+	/** Forces readers to treat the current values as new, e.g. after a state restore. Safe from any thread. */
+	void invalidate() { version.fetch_add(1, std::memory_order_acq_rel); }
+
+	/** Reads the current values. No lookups, no locks, no allocation. */
+	ChainSettings load() const;
+
+	/**
+	Refreshes settings only if something changed since lastSeenVersion, and updates lastSeenVersion.
+	Returns false (after one atomic load) when nothing did.
+	*/
+	bool loadIfChanged(ChainSettings &settings, juce::uint32 &lastSeenVersion) const {
+		const auto current = getVersion();
+		if (current == lastSeenVersion)
+			return false;
+
+		lastSeenVersion = current;
+		settings = load();
+		return true;
+	}
+
+private:
+	juce::AudioProcessorValueTreeState &apvts;
+
+	juce::AudioParameterFloat *lowCutFreq, *highCutFreq;
+
+	struct PeakHandles {
+		juce::AudioParameterFloat *freq, *gain, *quality;
+		juce::AudioParameterBool *enabled;
+	};
+
+	std::array<PeakHandles, maxPeakBands> peaks;
+
+	juce::AudioParameterChoice *lowCutSlope, *highCutSlope;
+	juce::AudioParameterChoice *topology;
+	juce::AudioParameterChoice *designMethod;
+	juce::AudioParameterChoice *oversampling;
+	juce::AudioParameterChoice *processingMode;
+
+	std::atomic<juce::uint32> version{ 1 };
+
+	void parameterValueChanged(int parameterIndex, float newValue) override;
+	void parameterGestureChanged(int parameterIndex, bool gestureIsStarting) override {}
+
+	template<typename ParameterType>
+	ParameterType *getHandle(const juce::String &parameterID);
+
+	JUCE_DECLARE_NON_COPYABLE(ParameterSnapshot)
+};
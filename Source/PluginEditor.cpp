@@ -10,49 +10,64 @@
 #include "PluginEditor.h"
 #include "Palette.h"
 
-void LookAndFeel::drawRotarySlider(
-	juce::Graphics &g,
-	int x,
-	int y,
-	int width,
-	int height,
-	float sliderPosProportional,
+namespace {
+	/** Renders draw() into an image covering area, at scale physical pixels per logical pixel. */
+	template<typename DrawFunction>
+	juce::Image renderLayer(juce::Rectangle<float> area, int imageWidth, int imageHeight, float scale, DrawFunction &&draw) {
+		juce::Image image(juce::Image::PixelFormat::ARGB, imageWidth, imageHeight, true);
+
+		juce::Graphics g(image);
+		g.addTransform(juce::AffineTransform::translation(-area.getX(), -area.getY()).scaled(scale));
+		draw(g);
+
+		return image;
+	}
+}
+
+const LookAndFeel::KnobLayers &LookAndFeel::getKnobLayers(
+	juce::Rectangle<float> bounds,
 	float rotaryStartAngle,
 	float rotaryEndAngle,
-	juce::Slider &slider
+	float scale
 ) {
 	using namespace juce;
 
-	auto bounds = Rectangle<float>(x, y, width + lineW, height + lineW);
+	for (auto &layers : knobCache) {
+		if (layers.bounds == bounds && layers.scale == scale
+			&& layers.rotaryStartAngle == rotaryStartAngle && layers.rotaryEndAngle == rotaryEndAngle)
+			return layers;
+	}
 
-	bounds.reduce(lineW, lineW);
+	if (knobCache.size() >= maxCachedKnobs)
+		knobCache.erase(knobCache.begin());
 
-	if (auto *rswl = dynamic_cast<RotarySliderWithLabels *>(&slider)) {
-		const auto &range = rswl->getNormalisableRange();
-		float skewedProportional = range.convertTo0to1(rswl->getValue());
+	// Room for the range arc around the knob and for the drop shadow below it.
+	auto area = bounds.expanded(lineW * 2.f + 2.f);
 
-		auto center = bounds.getCentre();
-		auto sliderAngRad = jmap(skewedProportional, 0.f, 1.f, rotaryStartAngle, rotaryEndAngle);
+	const int imageWidth = jmax(1, static_cast<int>(std::ceil(area.getWidth() * scale)));
+	const int imageHeight = jmax(1, static_cast<int>(std::ceil(area.getHeight() * scale)));
+	area.setSize(imageWidth / scale, imageHeight / scale);
 
-		float radius = juce::jmin(bounds.getWidth(), bounds.getHeight()) * 0.5f;
-		auto arcRadius = radius + lineW;
+	auto center = bounds.getCentre();
+	float radius = jmin(bounds.getWidth(), bounds.getHeight()) * 0.5f;
+	auto arcRadius = radius + lineW;
 
+	KnobLayers layers;
+	layers.bounds = bounds;
+	layers.scale = scale;
+	layers.rotaryStartAngle = rotaryStartAngle;
+	layers.rotaryEndAngle = rotaryEndAngle;
+	layers.area = area;
+
+	layers.track = renderLayer(area, imageWidth, imageHeight, scale, [&](Graphics &g) {
 		Path backgroundArc;
 		backgroundArc.addCentredArc(center.x, center.y, arcRadius, arcRadius,
 									0.0f, rotaryStartAngle, rotaryEndAngle, true);
 		g.setColour(Palette::KnobRange);
 		g.strokePath(backgroundArc, PathStrokeType(lineW));
+	});
 
-		// Draw value arc (slider angle)
-		Path valueArc;
-
-		valueArc.addCentredArc(center.x, center.y, arcRadius, arcRadius,
-							   0.0f, rotaryStartAngle, sliderAngRad, true);
-		g.setColour(Palette::KnobRangeApplied);
-		g.strokePath(valueArc, PathStrokeType(lineW));
-
-
-		// Draw the knob itself
+	layers.body = renderLayer(area, imageWidth, imageHeight, scale, [&](Graphics &g) {
 		Path knobShape;
 		knobShape.addEllipse(bounds);
 		DropShadow shadow(Colours::black.withAlpha(0.05f), 3, Point<int>(0, 2));
@@ -93,6 +108,56 @@ void LookAndFeel::drawRotarySlider(
 
 		g.setColour(Palette::KnobBorder);
 		g.drawEllipse(bounds, 1.f);
+	});
+
+	knobCache.push_back(std::move(layers));
+	return knobCache.back();
+}
+
+void LookAndFeel::drawRotarySlider(
+	juce::Graphics &g,
+	int x,
+	int y,
+	int width,
+	int height,
+	float sliderPosProportional,
+	float rotaryStartAngle,
+	float rotaryEndAngle,
+	juce::Slider &slider
+) {
+	using namespace juce;
+
+	auto bounds = Rectangle<float>(x, y, width + lineW, height + lineW);
+
+	bounds.reduce(lineW, lineW);
+
+	if (auto *rswl = dynamic_cast<RotarySliderWithLabels *>(&slider)) {
+		const auto &range = rswl->getNormalisableRange();
+		float skewedProportional = range.convertTo0to1(rswl->getValue());
+
+		auto center = bounds.getCentre();
+		auto sliderAngRad = jmap(skewedProportional, 0.f, 1.f, rotaryStartAngle, rotaryEndAngle);
+
+		float radius = juce::jmin(bounds.getWidth(), bounds.getHeight()) * 0.5f;
+		auto arcRadius = radius + lineW;
+
+		// Everything that doesn't move with the value comes from the cache, only the value arc
+		// and the indicator are drawn per frame.
+		const auto scale = g.getInternalContext().getPhysicalPixelScaleFactor();
+		const auto &layers = getKnobLayers(bounds, rotaryStartAngle, rotaryEndAngle, scale);
+
+		g.drawImage(layers.track, layers.area);
+
+		// Draw value arc (slider angle)
+		Path valueArc;
+
+		valueArc.addCentredArc(center.x, center.y, arcRadius, arcRadius,
+							   0.0f, rotaryStartAngle, sliderAngRad, true);
+		g.setColour(Palette::KnobRangeApplied);
+		g.strokePath(valueArc, PathStrokeType(lineW));
+
+		// Draw the knob itself
+		g.drawImage(layers.body, layers.area);
 
 		// Build vertical indicator bar (4px wide, height based on text)
 		Rectangle<float> r;
@@ -185,7 +250,7 @@ void RotarySliderWithLabels::paint(juce::Graphics &g) {
 	auto radius = sliderBounds.getWidth() * 0.5f;
 
 	g.setColour(Palette::TextColour);
-	static juce::Font font(FontManager::inter(getTextHeight(), regular));
+	const auto font = FontManager::inter(getTextHeight(), regular);
 	g.setFont(font);
 
 	int numChoices = labels.size();
@@ -272,7 +337,7 @@ void ControlsContainer::resized() {
 	if (knobCount == 0)
 		return;
 
-	static juce::Font lableFont(FontManager::inter(CardNameTextHeight, regular));
+	const auto lableFont = FontManager::inter(CardNameTextHeight, regular);
 	titleLabel.setFont(lableFont);
 
 	int knobNameHeight = static_cast<int>(knobLabelHeight); // add small margin
@@ -305,16 +370,15 @@ void ControlsContainer::resized() {
 //==============================================================================
 ResponseCurveComponent::ResponseCurveComponent(SimpleEQAudioProcessor &p):
 	audioProcessor(p),
-	leftPathProducer(audioProcessor.leftChannelFifo),
-	rightPathProducer(audioProcessor.rightChannelFifo) {
+	analyzer(audioProcessor) {
 	const auto &params = audioProcessor.getParameters();
 	for (auto param : params) {
 		param->addListener(this);
 	}
 
+	updateResponseCurve();
 
-	updateChain();
-
+	analyzer.startThread();
 	startTimerHz(60);
 }
 
@@ -329,160 +393,226 @@ void ResponseCurveComponent::parameterValueChanged(int parameterIndex, float new
 	parametersChanged.set(true);
 }
 
-void PathProducer::process(juce::Rectangle<float> fftBounds, double sampleRate) {
-	juce::AudioBuffer<float> tempIncomingBuffer;
+bool PathProducer::readStereo(juce::int64 position, int destStartSample, int numSamples) {
+	return leftFifo->read(position, stereoBuffer.getWritePointer(0, destStartSample), numSamples)
+		&& rightFifo->read(position, stereoBuffer.getWritePointer(1, destStartSample), numSamples);
+}
 
+bool PathProducer::process(juce::Rectangle<float> fftBounds, double sampleRate, FFTOrder order, float overlap, juce::uint32 enabledViews, AnalyzerPaths &latestPaths) {
+	FFTDataGenerator.changeOrder(order);
+
+	const int frameSize = stereoBuffer.getNumSamples();
+	const int hopSize = getHopSize(overlap);
+	const int maxFramesPerUpdate = getMaxFramesPerUpdate(overlap);
+	const auto writePosition = getWritePosition();
+	juce::int64 samplesAdvanced = 0;
+
+	// Frames older than the newest few would never reach the screen, so jump over them and
+	// refill the whole history with the audio leading up to the first frame we will compute.
+	if ((writePosition - readPosition) / hopSize > maxFramesPerUpdate) {
+		const auto skipped = ((writePosition - readPosition) / hopSize - maxFramesPerUpdate) * hopSize;
+		readPosition += skipped;
+		samplesAdvanced += skipped;
+
+		if (!readStereo(readPosition - frameSize, 0, frameSize)) {
+			// Not enough audio yet, or lapped mid-copy; start over from here on the next call.
+			readPosition = writePosition;
+			return false;
+		}
+	}
 
-	while (channelFifo->getNumCompleteBuffersAvailable() > 0) {
-		if (channelFifo->getAudioBuffer(tempIncomingBuffer)) {
-			auto size = tempIncomingBuffer.getNumSamples();
+	int numFrames = 0;
 
+	while (getWritePosition() - readPosition >= hopSize) {
+		for (int ch = 0; ch < stereoBuffer.getNumChannels(); ++ch) {
 			juce::FloatVectorOperations::copy(
-				monoBuffer.getWritePointer(0, 0),
-				monoBuffer.getReadPointer(0, size),
-				monoBuffer.getNumSamples() - size
-			);
-
-			juce::FloatVectorOperations::copy(
-				monoBuffer.getWritePointer(0, monoBuffer.getNumSamples() - size),
-				tempIncomingBuffer.getReadPointer(0, 0),
-				size
+				stereoBuffer.getWritePointer(ch, 0),
+				stereoBuffer.getReadPointer(ch, hopSize),
+				frameSize - hopSize
 			);
+		}
 
-			FFTDataGenerator.producerFFTDataForRendering(monoBuffer, -96.f);
+		if (!readStereo(readPosition, frameSize - hopSize, hopSize)) {
+			// Lapped by the audio thread mid-copy; catch up on the next call.
+			readPosition = getWritePosition() - leftFifo->getCapacity();
+			break;
 		}
+
+		readPosition += hopSize;
+		samplesAdvanced += hopSize;
+		++numFrames;
+
+		FFTDataGenerator.producerFFTDataForRendering(stereoBuffer, enabledViews, -96.f);
 	}
 
+	if (numFrames == 0)
+		return false;
+
+	/*
+	Each computed frame stands for its share of all the audio that went by, skipped frames included,
+	so the envelope rises and falls at the same speed whether or not frames were skipped.
+	*/
+	const auto secondsPerFrame = static_cast<float>(static_cast<double>(samplesAdvanced) / (sampleRate * numFrames));
+	const auto attack = 1.f - std::exp2(-secondsPerFrame / envelopeAttackHalfLifeSeconds);
+	const auto decay = envelopeDecayDbPerSecond * secondsPerFrame;
 
 	/*
-	if there are FFT data buffers to pul
-	if we can pull a buffer
-	generate a path.
+	fold every frame into the envelopes of the views that are on,
+	then generate one path per view from them.
 	*/
 	const auto fftSize = FFTDataGenerator.getFFTSize();
+	const int numBins = fftSize / 2;
 
 	/*
 	4800 / 2048 = 23hz <- this is the bin width
 	*/
 	const auto binWidth = sampleRate / static_cast<double>(fftSize);
 
-	while (FFTDataGenerator.getNumAvailableFFTDataBlocks() > 0) {
-		std::vector<float> fftData;
-		if (FFTDataGenerator.getFFTData(fftData)) {
-			pathProducer.generatePath(fftData, fftBounds, fftSize, binWidth, -96.f);
-		}
+	while (auto *fftData = FFTDataGenerator.acquireFFTData()) {
+		for (int view = 0; view < numAnalyzerViews; ++view)
+			if ((enabledViews & getAnalyzerViewBit(static_cast<AnalyzerView>(view))) != 0)
+				pathProducers[static_cast<size_t>(view)].updateEnvelope(fftData->data() + view * numBins, numBins, attack, decay, -96.f);
+
+		FFTDataGenerator.releaseFFTData();
 	}
 
+	for (int view = 0; view < numAnalyzerViews; ++view)
+		if ((enabledViews & getAnalyzerViewBit(static_cast<AnalyzerView>(view))) != 0)
+			pathProducers[static_cast<size_t>(view)].generatePath(fftBounds, fftSize, binWidth, -96.f);
+
 	/*
 	while there are paths that we can pull
 	pull as many as we can
 	display the most recent path
 	*/
+	bool gotAny = false;
 
-	while (pathProducer.getNumPathsAvailable()) {
-		pathProducer.getPath(FFTPath);
+	for (int view = 0; view < numAnalyzerViews; ++view) {
+		auto &path = latestPaths[static_cast<size_t>(view)];
+
+		if ((enabledViews & getAnalyzerViewBit(static_cast<AnalyzerView>(view))) != 0)
+			gotAny |= pathProducers[static_cast<size_t>(view)].swapLatestPath(path);
+		else
+			path.clear();
 	}
-}
 
-void ResponseCurveComponent::timerCallback() {
+	return gotAny;
+}
 
-	auto fftBounds = getAnalysisArea().toFloat();
-	auto sampleRate = audioProcessor.getSampleRate();
-	fftBounds.removeFromRight(30.f);
+//==============================================================================
+AnalyzerThread::AnalyzerThread(SimpleEQAudioProcessor &p):
+	juce::Thread("SimpleEQ Analyzer"),
+	audioProcessor(p),
+	pathProducer(audioProcessor.leftChannelFifo, audioProcessor.rightChannelFifo) {}
 
-	leftPathProducer.process(fftBounds, sampleRate);
-	rightPathProducer.process(fftBounds, sampleRate);
+AnalyzerThread::~AnalyzerThread() {
+	stopThread(1000);
+}
 
-	if (parametersChanged.compareAndSetBool(false, true)) {
-		// update the monochain
-		updateChain();
+void AnalyzerThread::setAnalysisBounds(juce::Rectangle<float> bounds) {
+	analysisBounds.getWriteBuffer() = bounds;
+	analysisBounds.publish();
+}
 
-		// signal a repaint
-		//repaint();
-	}
+void AnalyzerThread::pullLatestPaths() {
+	paths.acquire();
+}
 
-	repaint();
+const juce::Path &AnalyzerThread::getPath(AnalyzerView view) const {
+	return paths.getReadBuffer()[static_cast<size_t>(view)];
 }
 
-void ResponseCurveComponent::updateChain() {
+void AnalyzerThread::run() {
+	juce::Rectangle<float> fftBounds;
 
-	const double sampleRate = audioProcessor.getSampleRate();
+	while (!threadShouldExit()) {
+		if (analysisBounds.acquire())
+			fftBounds = analysisBounds.getReadBuffer();
 
-	auto chainSettings = getChainSettings(audioProcessor.apvts);
-	auto peakCoefficients = makePeakFilter(chainSettings, sampleRate);
-	updateCoefficients(monoChain.get<ChainPositions::Peak>().coefficients, peakCoefficients);
+		// Nothing to analyse until the host has prepared the processor.
+		const auto sampleRate = audioProcessor.getAnalyzerSampleRate();
+
+		if (!fftBounds.isEmpty() && sampleRate > 0) {
+			const auto order = static_cast<FFTOrder>(fftOrder.load(std::memory_order_relaxed));
 
-	auto lowCutCoefficients = makeLowCutFilter(chainSettings, sampleRate);
-	auto highCutCoefficients = makeHighCutFilter(chainSettings, sampleRate);
+			if (pathProducer.process(fftBounds, sampleRate, order, overlap.load(std::memory_order_relaxed),
+									 enabledViews.load(std::memory_order_relaxed), paths.getWriteBuffer()))
+				paths.publish();
+		}
 
-	updateCutFilter(monoChain.get<ChainPositions::LowCut>(), lowCutCoefficients, chainSettings.lowCutSlope);
-	updateCutFilter(monoChain.get<ChainPositions::HighCut>(), highCutCoefficients, chainSettings.highCutSlope);
+		wait(frameIntervalMs);
+	}
 }
 
-void ResponseCurveComponent::paint(juce::Graphics &g) {
-	using namespace juce;
+//==============================================================================
+void ResponseCurveComponent::timerCallback() {
+	analyzer.pullLatestPaths();
 
-	g.drawImage(background, getLocalBounds().toFloat());
+	if (parametersChanged.compareAndSetBool(false, true)) {
+		updateResponseCurve();
+
+		// signal a repaint
+		//repaint();
+	}
+
+	repaint();
+}
+
+void ResponseCurveComponent::updateResponseCurve() {
+	using namespace juce;
 
 	auto responseArea = getAnalysisArea();
 
-	auto w = responseArea.getWidth();
+	// The editor can exist before the host has prepared the processor.
+	auto sampleRate = audioProcessor.getAnalyzerSampleRate();
+	if (sampleRate <= 0)
+		sampleRate = 44100.0;
 
-	auto &lowcut = monoChain.get<ChainPositions::LowCut>();
-	auto &peak = monoChain.get<ChainPositions::Peak>();
-	auto &highcut = monoChain.get<ChainPositions::HighCut>();
+	const bool resizedOrRateChanged = responseCurveCache.prepare(responseArea.getWidth(), sampleRate);
 
-	auto sampleRate = audioProcessor.getSampleRate();
+	auto chainSettings = getChainSettings(audioProcessor.apvts);
 
-	std::vector <double> mags;
+	// The linear phase FIR is built from a host rate design, so the curve has to be as well.
+	if (chainSettings.linearPhase)
+		chainSettings.oversamplingOrder = 0;
 
-	mags.resize(w);
-	for (int i = 0; i < w; ++i) {
-		double mag = 1.f;
-		auto freq = mapToLog10((static_cast<double>(i) / static_cast<double>(w)), 20.0, 20000.0);
+	const bool coefficientsChanged = responseCurveCache.update(designCoefficients(chainSettings, sampleRate));
 
-		if (!monoChain.isBypassed<ChainPositions::Peak>())
-			mag *= peak.coefficients->getMagnitudeForFrequency(freq, sampleRate);
+	if (!resizedOrRateChanged && !coefficientsChanged && responseArea == responseCurveArea)
+		return;
 
-		if (!lowcut.isBypassed<0>())
-			mag *= lowcut.get<0>().coefficients->getMagnitudeForFrequency(freq, sampleRate);
-		if (!lowcut.isBypassed<1>())
-			mag *= lowcut.get<1>().coefficients->getMagnitudeForFrequency(freq, sampleRate);
-		if (!lowcut.isBypassed<2>())
-			mag *= lowcut.get<2>().coefficients->getMagnitudeForFrequency(freq, sampleRate);
-		if (!lowcut.isBypassed<3>())
-			mag *= lowcut.get<3>().coefficients->getMagnitudeForFrequency(freq, sampleRate);
+	responseCurveArea = responseArea;
 
-		if (!highcut.isBypassed<0>())
-			mag *= highcut.get<0>().coefficients->getMagnitudeForFrequency(freq, sampleRate);
-		if (!highcut.isBypassed<1>())
-			mag *= highcut.get<1>().coefficients->getMagnitudeForFrequency(freq, sampleRate);
-		if (!highcut.isBypassed<2>())
-			mag *= highcut.get<2>().coefficients->getMagnitudeForFrequency(freq, sampleRate);
-		if (!highcut.isBypassed<3>())
-			mag *= highcut.get<3>().coefficients->getMagnitudeForFrequency(freq, sampleRate);
+	const auto &mags = responseCurveCache.getMagnitudesInDecibels();
 
-		mags[i] = Decibels::gainToDecibels(mag);
-	}
+	responseCurve.clear();
 
-	Path responseCurve;
-	const double outputMin = responseArea.getBottom();
-	const double outputMax = responseArea.getY();
-	auto map = [outputMin, outputMax](double input) {
-		return jmap(input, -24.0, 24.0, outputMin, outputMax);
+	if (mags.empty())
+		return;
+
+	const float outputMin = static_cast<float>(responseArea.getBottom());
+	const float outputMax = static_cast<float>(responseArea.getY());
+	auto map = [outputMin, outputMax](float input) {
+		return jmap(input, -24.f, 24.f, outputMin, outputMax);
 		};
 
-	responseCurve.startNewSubPath(responseArea.getX(), map(mags.front()));
+	responseCurve.preallocateSpace(static_cast<int>(mags.size()) * 3);
+	responseCurve.startNewSubPath(static_cast<float>(responseArea.getX()), map(mags.front()));
 
 	for (size_t i = 1; i < mags.size(); ++i) {
-		responseCurve.lineTo(responseArea.getX() + i, map(mags[i]));
+		responseCurve.lineTo(static_cast<float>(responseArea.getX() + static_cast<int>(i)), map(mags[i]));
 	}
+}
 
-	auto leftChannelFFTPath = leftPathProducer.getPath();
-	auto rightChannelFFTPath = rightPathProducer.getPath();
+void ResponseCurveComponent::paint(juce::Graphics &g) {
+	using namespace juce;
+
+	g.drawImage(background, getLocalBounds().toFloat());
+
+	auto responseArea = getAnalysisArea();
 
-	leftChannelFFTPath.applyTransform(AffineTransform().translation(responseArea.getX(), responseArea.getY()));
-	rightChannelFFTPath.applyTransform(AffineTransform().translation(responseArea.getX(), responseArea.getY()));
+	// The analyzer lays its paths out relative to the analysis area.
+	const auto analyzerTransform = AffineTransform::translation(responseArea.getX(), responseArea.getY());
 
 	ColourGradient FFTBodyGradient(
 		Palette::FFTBodyGradient3,
@@ -493,25 +623,37 @@ void ResponseCurveComponent::paint(juce::Graphics &g) {
 	);
 	FFTBodyGradient.addColour(0.1f, Palette::FFTBodyGradient2);
 
-	g.setGradientFill(FFTBodyGradient);
-	g.fillPath(leftChannelFFTPath);
-	//g.fillPath(rightChannelFFTPath);
+	const Colour outlineColours[numAnalyzerViews] = {
+		Palette::FFTOutlineGradient1,
+		Palette::FFTRightOutline,
+		Palette::FFTMidOutline,
+		Palette::FFTSideOutline
+	};
 
+	// Every view that's on gets the same faint body, and an outline in its own colour.
+	for (int view = 0; view < numAnalyzerViews; ++view) {
+		if ((analyzerViews & getAnalyzerViewBit(static_cast<AnalyzerView>(view))) == 0)
+			continue;
 
-	ColourGradient FFTOutlineGradient(
-		Palette::FFTOutlineGradient3,
-		responseArea.getCentreX(), responseArea.getBottom(),
-		Palette::FFTOutlineGradient1,
-		responseArea.getCentreX(), responseArea.getY(),
-		false
-	);
-	FFTOutlineGradient.addColour(0.05f, Palette::FFTOutlineGradient2);
+		const auto &spectrumPath = analyzer.getPath(static_cast<AnalyzerView>(view));
+
+		g.setGradientFill(FFTBodyGradient);
+		g.fillPath(spectrumPath, analyzerTransform);
+
+		ColourGradient FFTOutlineGradient(
+			Palette::FFTOutlineGradient3,
+			responseArea.getCentreX(), responseArea.getBottom(),
+			outlineColours[view],
+			responseArea.getCentreX(), responseArea.getY(),
+			false
+		);
+		FFTOutlineGradient.addColour(0.05f, Palette::FFTOutlineGradient2);
 
-	FFTOutlineGradient.multiplyOpacity(0.5f);
+		FFTOutlineGradient.multiplyOpacity(0.5f);
 
-	g.setGradientFill(FFTOutlineGradient);
-	g.strokePath(leftChannelFFTPath, PathStrokeType(1.f));
-	//g.strokePath(rightChannelFFTPath, PathStrokeType(1.f));
+		g.setGradientFill(FFTOutlineGradient);
+		g.strokePath(spectrumPath, PathStrokeType(1.f), analyzerTransform);
+	}
 
 	auto bounds = background.getBounds();
 
@@ -527,8 +669,21 @@ void ResponseCurveComponent::paint(juce::Graphics &g) {
 	g.strokePath(responseCurve, PathStrokeType(2.f));
 }
 
+void ResponseCurveComponent::setAnalyzerViews(juce::uint32 views) {
+	analyzerViews = views;
+	analyzer.setEnabledViews(views);
+	repaint();
+}
+
 void ResponseCurveComponent::resized() {
 	using namespace juce;
+
+	auto fftBounds = getAnalysisArea().toFloat();
+	fftBounds.removeFromRight(30.f);
+	analyzer.setAnalysisBounds(fftBounds);
+
+	updateResponseCurve();
+
 	background = Image(Image::PixelFormat::ARGB, getWidth(), getHeight(), true);
 
 	Graphics g(background);
@@ -566,7 +721,7 @@ void ResponseCurveComponent::resized() {
 		12, 9, 6, 3, 0, -3, -6, -9, -12,
 	};
 
-	static juce::Font font(FontManager::inter(fontHeight, regular));
+	const auto font = FontManager::inter(fontHeight, regular);
 	g.setFont(font);
 
 	for (float gDb : gain) {
@@ -673,9 +828,6 @@ SimpleEQAudioProcessorEditor::SimpleEQAudioProcessorEditor(SimpleEQAudioProcesso
 	highCutSlopeSlider(*audioProcessor.apvts.getParameter("HighCut Slope"), "dB/Oct", "SLOPE"),
 
 
-	peakFreqSliderAttachment(audioProcessor.apvts, "Peak Freq", peakFreqSlider),
-	peakGainSliderAttachment(audioProcessor.apvts, "Peak Gain", peakGainSlider),
-	peakQualitySliderAttachment(audioProcessor.apvts, "Peak Quality", peakQualitySlider),
 	lowCutFreqSliderAttachment(audioProcessor.apvts, "LowCut Freq", lowCutFreqSlider),
 	highCutFreqSliderAttachment(audioProcessor.apvts, "HighCut Freq", highCutFreqSlider),
 	lowCutSlopeSliderAttachment(audioProcessor.apvts, "LowCut Slope", lowCutSlopeSlider),
@@ -688,7 +840,8 @@ SimpleEQAudioProcessorEditor::SimpleEQAudioProcessorEditor(SimpleEQAudioProcesso
 	// Make sure that before the constructor has finished, you've set the
 	// editor's size to whatever you need it to be.
 
-
+	// Everything the editor ever writes. Only the first editor in the process pays for this.
+	FontManager::prewarm("0123456789.+-/ kHzdBOctFREQGAINSLOPEQLowCutPeakControlHigh");
 
 	peakFreqSlider.labels.add({ 0.f, "20Hz" });
 	peakFreqSlider.labels.add({ 1.f, "20kHz" });
@@ -721,6 +874,71 @@ SimpleEQAudioProcessorEditor::SimpleEQAudioProcessorEditor(SimpleEQAudioProcesso
 	highCutControls.addKnob(&highCutFreqSlider);
 	highCutControls.addKnob(&highCutSlopeSlider);
 
+	const juce::var savedViews = audioProcessor.apvts.state.getProperty("AnalyzerViews");
+	const auto views = savedViews.isVoid()
+		? getAnalyzerViewBit(View_Left) | getAnalyzerViewBit(View_Right)
+		: static_cast<juce::uint32>(static_cast<int>(savedViews));
+
+	const char *viewNames[numAnalyzerViews] = { "L", "R", "M", "S" };
+
+	for (int view = 0; view < numAnalyzerViews; ++view) {
+		auto &button = analyzerViewButtons[static_cast<size_t>(view)];
+		button.setButtonText(viewNames[view]);
+		button.setClickingTogglesState(true);
+		button.setToggleState((views & getAnalyzerViewBit(static_cast<AnalyzerView>(view))) != 0, juce::dontSendNotification);
+		button.onClick = [this] { updateAnalyzerViews(); };
+		addAndMakeVisible(button);
+	}
+
+	responseCurveComponent.setAnalyzerViews(views);
+
+	for (int order = minFFTOrder; order <= maxFFTOrder; ++order)
+		analyzerOrderBox.addItem(juce::String(1 << order), order - minFFTOrder + 1);
+
+	const int savedOrder = audioProcessor.apvts.state.getProperty("AnalyzerOrder", static_cast<int>(order2048));
+	analyzerOrderBox.setSelectedId(juce::jlimit<int>(minFFTOrder, maxFFTOrder, savedOrder) - minFFTOrder + 1, juce::dontSendNotification);
+	analyzerOrderBox.onChange = [this] { updateAnalyzerOrder(); };
+	addAndMakeVisible(analyzerOrderBox);
+
+	updateAnalyzerOrder();
+
+	analyzerOverlapBox.addItemList({ "50%", "75%", "87.5%" }, 1);
+
+	const float savedOverlap = audioProcessor.apvts.state.getProperty("AnalyzerOverlap", PathProducer::defaultOverlap);
+	analyzerOverlapBox.setSelectedId(savedOverlap < 0.625f ? 1 : savedOverlap < 0.8125f ? 2 : 3, juce::dontSendNotification);
+	analyzerOverlapBox.onChange = [this] { updateAnalyzerOverlap(); };
+	addAndMakeVisible(analyzerOverlapBox);
+
+	updateAnalyzerOverlap();
+
+	for (int band = 0; band < maxPeakBands; ++band)
+		peakBandBox.addItem("Peak " + juce::String(band + 1), band + 1);
+
+	const int savedBand = audioProcessor.apvts.state.getProperty("PeakBand", 0);
+	peakBandBox.setSelectedId(juce::jlimit(0, maxPeakBands - 1, savedBand) + 1, juce::dontSendNotification);
+	peakBandBox.onChange = [this] { selectPeakBand(peakBandBox.getSelectedId() - 1); };
+	addAndMakeVisible(peakBandBox);
+
+	peakBandEnabledButton.setClickingTogglesState(true);
+	addAndMakeVisible(peakBandEnabledButton);
+
+	selectPeakBand(peakBandBox.getSelectedId() - 1);
+
+	const auto attachChoice = [this](juce::ComboBox &box, const juce::String &parameterID) {
+		auto *choice = dynamic_cast<juce::AudioParameterChoice *>(audioProcessor.apvts.getParameter(parameterID));
+		jassert(choice != nullptr);
+
+		box.addItemList(choice->choices, 1);
+		addAndMakeVisible(box);
+
+		return std::make_unique<APVTS::ComboBoxAttachment>(audioProcessor.apvts, parameterID, box);
+	};
+
+	topologyAttachment = attachChoice(topologyBox, "Filter Topology");
+	designAttachment = attachChoice(designBox, "Filter Design");
+	oversamplingAttachment = attachChoice(oversamplingBox, "Oversampling");
+	processingModeAttachment = attachChoice(processingModeBox, "Processing Mode");
+
 	for (auto *comp : getComps()) {
 		addAndMakeVisible(comp);
 	}
@@ -734,6 +952,58 @@ SimpleEQAudioProcessorEditor::SimpleEQAudioProcessorEditor(SimpleEQAudioProcesso
 SimpleEQAudioProcessorEditor::~SimpleEQAudioProcessorEditor() {
 }
 
+void SimpleEQAudioProcessorEditor::updateAnalyzerViews() {
+	juce::uint32 views = 0;
+
+	for (int view = 0; view < numAnalyzerViews; ++view)
+		if (analyzerViewButtons[static_cast<size_t>(view)].getToggleState())
+			views |= getAnalyzerViewBit(static_cast<AnalyzerView>(view));
+
+	// Not a parameter, since nothing about the sound depends on it, but it's kept with the session.
+	audioProcessor.apvts.state.setProperty("AnalyzerViews", static_cast<int>(views), nullptr);
+	responseCurveComponent.setAnalyzerViews(views);
+}
+
+void SimpleEQAudioProcessorEditor::updateAnalyzerOrder() {
+	const auto order = static_cast<FFTOrder>(minFFTOrder + analyzerOrderBox.getSelectedId() - 1);
+
+	audioProcessor.apvts.state.setProperty("AnalyzerOrder", static_cast<int>(order), nullptr);
+	responseCurveComponent.setAnalyzerOrder(order);
+}
+
+void SimpleEQAudioProcessorEditor::updateAnalyzerOverlap() {
+	const float overlaps[] = { 0.5f, 0.75f, 0.875f };
+	const auto overlap = overlaps[analyzerOverlapBox.getSelectedItemIndex()];
+
+	audioProcessor.apvts.state.setProperty("AnalyzerOverlap", overlap, nullptr);
+	responseCurveComponent.setAnalyzerOverlap(overlap);
+}
+
+void SimpleEQAudioProcessorEditor::selectPeakBand(int band) {
+	auto &apvts = audioProcessor.apvts;
+
+	const auto freqID = getPeakParameterID(band, "Freq");
+	const auto gainID = getPeakParameterID(band, "Gain");
+	const auto qualityID = getPeakParameterID(band, "Quality");
+
+	// The old attachments go first, or they'd write the new band's values into the old band.
+	peakFreqSliderAttachment.reset();
+	peakGainSliderAttachment.reset();
+	peakQualitySliderAttachment.reset();
+	peakBandEnabledAttachment.reset();
+
+	peakFreqSlider.setParameter(*apvts.getParameter(freqID));
+	peakGainSlider.setParameter(*apvts.getParameter(gainID));
+	peakQualitySlider.setParameter(*apvts.getParameter(qualityID));
+
+	peakFreqSliderAttachment = std::make_unique<Attachment>(apvts, freqID, peakFreqSlider);
+	peakGainSliderAttachment = std::make_unique<Attachment>(apvts, gainID, peakGainSlider);
+	peakQualitySliderAttachment = std::make_unique<Attachment>(apvts, qualityID, peakQualitySlider);
+	peakBandEnabledAttachment = std::make_unique<APVTS::ButtonAttachment>(apvts, getPeakParameterID(band, "Enabled"), peakBandEnabledButton);
+
+	apvts.state.setProperty("PeakBand", band, nullptr);
+}
+
 //==============================================================================
 void SimpleEQAudioProcessorEditor::paint(juce::Graphics &g) {
 	using namespace juce;
@@ -759,7 +1029,32 @@ void SimpleEQAudioProcessorEditor::resized() {
 
 	auto bounds = getLocalBounds();
 
-	bounds.removeFromTop(80);
+	// The analyzer's controls sit in the header above the right end of the response area, the rest on the left.
+	auto header = bounds.removeFromTop(80).reduced(24, 24);
+
+	for (auto it = analyzerViewButtons.rbegin(); it != analyzerViewButtons.rend(); ++it) {
+		it->setBounds(header.removeFromRight(32));
+		header.removeFromRight(4);
+	}
+
+	header.removeFromRight(8);
+	analyzerOrderBox.setBounds(header.removeFromRight(80));
+	header.removeFromRight(4);
+	analyzerOverlapBox.setBounds(header.removeFromRight(80));
+
+	// The peak card's band, then the processing options, from the left.
+	peakBandBox.setBounds(header.removeFromLeft(90));
+	header.removeFromLeft(4);
+	peakBandEnabledButton.setBounds(header.removeFromLeft(40));
+	header.removeFromLeft(24);
+
+	topologyBox.setBounds(header.removeFromLeft(130));
+	header.removeFromLeft(8);
+	designBox.setBounds(header.removeFromLeft(160));
+	header.removeFromLeft(8);
+	oversamplingBox.setBounds(header.removeFromLeft(60));
+	header.removeFromLeft(8);
+	processingModeBox.setBounds(header.removeFromLeft(130));
 
 	auto responseArea = bounds.removeFromTop(483);
 
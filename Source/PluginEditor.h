@@ -10,178 +10,391 @@
 
 #include <JuceHeader.h>
 #include "PluginProcessor.h"
+#include "LockFree.h"
+#include "ResponseCurveCache.h"
 #include "FontManager.h"
 #include "Palette.h"
 
 enum FFTOrder {
 	order2048 = 11,
 	order4096 = 12,
-	order8192 = 13
+	order8192 = 13,
+
+	minFFTOrder = order2048,
+	maxFFTOrder = order8192
 };
 
+constexpr int numFFTOrders = maxFFTOrder - minFFTOrder + 1;
+
+/*
+What the analyzer can show. Every view comes out of the same transform, so showing more of them
+only costs the magnitude, the dB conversion and a path each.
+*/
+enum AnalyzerView {
+	View_Left,
+	View_Right,
+	View_Mid,
+	View_Side,
+	numAnalyzerViews
+};
+
+inline juce::uint32 getAnalyzerViewBit(AnalyzerView view) { return 1u << static_cast<int>(view); }
+
 template<typename BlockType>
 struct FFTDataGenerator {
 	/**
-	produces the FFT data from an audio buffer.
+	Produces the spectra of a stereo frame from one complex FFT, with the left channel in the real
+	part and the right channel in the imaginary part. The frame is the newest fftSize samples of
+	audioData. It holds numAnalyzerViews spectra of fftSize / 2 bins each, in AnalyzerView order.
+	Views missing from enabledViews aren't computed.
 	*/
-	void producerFFTDataForRendering(const juce::AudioBuffer<float> &audioData, const float negativeInfinity) {
+	void producerFFTDataForRendering(const juce::AudioBuffer<float> &audioData, juce::uint32 enabledViews, const float negativeInfinity) {
+		// Nobody will read this frame if the fifo is full, so don't compute it.
+		auto *slot = fftDataFifo.acquireWrite();
+		if (slot == nullptr)
+			return;
+
+		auto &fftData = *slot;
 		const auto fftSize = getFFTSize();
+		const int numBins = fftSize / 2;
+		const auto &plan = plans[static_cast<size_t>(order - minFFTOrder)];
+
+		jassert(audioData.getNumSamples() >= fftSize);
+		const int start = audioData.getNumSamples() - fftSize;
+
+		// A mono bus only has the one channel, which then is both.
+		const auto *left = audioData.getReadPointer(0, start);
+		const auto *right = audioData.getReadPointer(audioData.getNumChannels() > 1 ? 1 : 0, start);
+		const auto &window = plan.window;
+
+		for (int i = 0; i < fftSize; ++i)
+			timeData[static_cast<size_t>(i)] = { left[i] * window[static_cast<size_t>(i)], right[i] * window[static_cast<size_t>(i)] };
+
+		plan.fft->perform(timeData.data(), spectrum.data(), false);
+
+		/*
+		With z = l + j r, Z[k] = L[k] + j R[k], and since l and r are real, conj(Z[N - k]) = L[k] - j R[k].
+		So L[k] = (Z[k] + conj(Z[N - k])) / 2 and R[k] = (Z[k] - conj(Z[N - k])) / 2j.
+		Mid and side are then just the sum and difference, with no transforms of their own.
+
+		This pass only separates the views and leaves each bin's power in the frame. It's cheap and
+		branch-free, so it fills every view; the log, which is what costs, only runs for enabled ones.
+		*/
+		auto *leftOut = fftData.data() + View_Left * numBins;
+		auto *rightOut = fftData.data() + View_Right * numBins;
+		auto *midOut = fftData.data() + View_Mid * numBins;
+		auto *sideOut = fftData.data() + View_Side * numBins;
+
+		for (int k = 0; k < numBins; ++k) {
+			const auto z = spectrum[static_cast<size_t>(k)];
+			const auto mirrored = spectrum[static_cast<size_t>((fftSize - k) & (fftSize - 1))];
+
+			const auto lRe = 0.5f * (z.real() + mirrored.real());
+			const auto lIm = 0.5f * (z.imag() - mirrored.imag());
+			const auto rRe = 0.5f * (z.imag() + mirrored.imag());
+			const auto rIm = 0.5f * (mirrored.real() - z.real());
+
+			leftOut[k] = lRe * lRe + lIm * lIm;
+			rightOut[k] = rRe * rRe + rIm * rIm;
+			midOut[k] = 0.25f * ((lRe + rRe) * (lRe + rRe) + (lIm + rIm) * (lIm + rIm));
+			sideOut[k] = 0.25f * ((lRe - rRe) * (lRe - rRe) + (lIm - rIm) * (lIm - rIm));
+		}
 
-		fftData.assign(fftData.size(), 0);
-		auto *readIndex = audioData.getReadPointer(0);
-		std::copy(readIndex, readIndex + fftSize, fftData.begin());
+		// The FFT isn't normalised, so a full scale sine comes out with a magnitude of numBins.
+		const auto powerScale = 1.f / static_cast<float>(numBins * numBins);
 
-		//first apply a windowing function to our data
-		window->multiplyWithWindowingTable(fftData.data(), fftSize);		// [1]
+		for (int view = 0; view < numAnalyzerViews; ++view)
+			if ((enabledViews & getAnalyzerViewBit(static_cast<AnalyzerView>(view))) != 0)
+				powerToDecibels(fftData.data() + view * numBins, numBins, powerScale, negativeInfinity);
 
-		//then render our FFT data..
-		forwardFFT->performFrequencyOnlyForwardTransform(fftData.data());	// [2]
+		fftDataFifo.commitWrite();
+	}
 
-		int numBins = (int)fftSize / 2;
+	/** Builds the FFT and window of every order, and sizes everything for the largest one. Not real-time safe. */
+	void prepare(FFTOrder initialOrder) {
+		for (int i = 0; i < numFFTOrders; ++i) {
+			auto &plan = plans[static_cast<size_t>(i)];
+			const int fftSize = 1 << (minFFTOrder + i);
 
-		//normalize the fft values.
-		for (int i = 0; i < numBins; ++i) {
-			fftData[i] /= (float)numBins;
-		}
+			plan.fft = std::make_unique<juce::dsp::FFT>(minFFTOrder + i);
 
-		//convert them to decibels
-		for (int i = 0; i < numBins; ++i) {
-			fftData[i] = juce::Decibels::gainToDecibels(fftData[i], negativeInfinity);
+			plan.window.resize(static_cast<size_t>(fftSize));
+			juce::dsp::WindowingFunction<float>::fillWindowingTables(plan.window.data(), plan.window.size(),
+																	  juce::dsp::WindowingFunction<float>::blackmanHarris);
 		}
 
-		fftDataFifo.push(fftData);
+		const int maxFFTSize = 1 << maxFFTOrder;
+
+		timeData.resize(static_cast<size_t>(maxFFTSize));
+		spectrum.resize(static_cast<size_t>(maxFFTSize));
+
+		// maxFFTSize / 2 bins for each view, of which a smaller order uses the front.
+		fftDataFifo.prepare(static_cast<size_t>(numAnalyzerViews * maxFFTSize / 2));
+
+		order = initialOrder;
 	}
 
+	/**
+	Switches to another prepared order without allocating. Frames still queued were made at the old
+	size, so they're dropped. Only call this from the thread that also reads the frames.
+	*/
 	void changeOrder(FFTOrder newOrder) {
-		//when you change order, recreate the window, forwardFFT, fifo, fftData
-		//also reset the fifoIndex
-		//things that need recreating should be created on the heap via std::make_unique<>
-
-		order = newOrder;
-		auto fftSize = getFFTSize();
+		jassert(plans.front().fft != nullptr);
 
-		forwardFFT = std::make_unique<juce::dsp::FFT>(order);
-		window = std::make_unique<juce::dsp::WindowingFunction<float>>(
-			fftSize,
-			juce::dsp::WindowingFunction<float>::blackmanHarris
-		);
+		if (newOrder == order)
+			return;
 
-		fftData.clear();
-		fftData.resize(fftSize * 2, 0);
+		while (fftDataFifo.acquireRead() != nullptr)
+			fftDataFifo.release();
 
-		fftDataFifo.prepare(fftData.size());
+		order = newOrder;
 	}
+
+	FFTOrder getOrder() const { return order; }
 	//==============================================================================
 	int getFFTSize() const { return 1 << order; }
 	int getNumAvailableFFTDataBlocks() const { return fftDataFifo.getNumAvailableForReading(); }
 	//==============================================================================
-	bool getFFTData(BlockType &fftData) { return fftDataFifo.pull(fftData); }
+	/** The oldest finished frame, read in place, or nullptr. Hand it back with releaseFFTData(). */
+	const BlockType *acquireFFTData() { return fftDataFifo.acquireRead(); }
+	void releaseFFTData() { fftDataFifo.release(); }
 private:
-	FFTOrder order;
-	BlockType fftData;
-	std::unique_ptr<juce::dsp::FFT> forwardFFT;
-	std::unique_ptr<juce::dsp::WindowingFunction<float>> window;
+	struct Plan {
+		std::unique_ptr<juce::dsp::FFT> fft;
+		std::vector<float> window;
+	};
+
+	FFTOrder order{ minFFTOrder };
+	std::array<Plan, numFFTOrders> plans;
+	std::vector<juce::dsp::Complex<float>> timeData, spectrum;
 
 	Fifo<BlockType> fftDataFifo;
+
+	/*
+	10 log10(power * scale) in place, floored at floorDb. The floor is applied to the power before
+	the log, so silence and denormals never reach it and no clamp is needed after.
+
+	log2 is the exponent, read straight from the float's bits, plus a cubic in the mantissa fitted
+	with its ends pinned, so neighbouring octaves join up. The cubic is within 8.8e-4 of log2, which
+	is under 0.003 dB. The loop has no branches or library calls, so the compiler vectorises it.
+	*/
+	static void powerToDecibels(float *data, int numValues, float scale, float floorDb) {
+		const auto floorPower = std::pow(10.f, floorDb / 10.f) / scale;
+		const auto decibelsPerOctave = 10.f * std::log10(2.f);
+		const auto offset = 10.f * std::log10(scale);
+
+		for (int i = 0; i < numValues; ++i) {
+			// A plain select rather than std::max, which GCC won't vectorise here.
+			const auto power = data[i] > floorPower ? data[i] : floorPower;
+
+			uint32_t bits;
+			std::memcpy(&bits, &power, sizeof(bits));
+
+			const auto exponent = static_cast<float>(static_cast<int32_t>(bits >> 23) - 127);
+			const uint32_t mantissaBits = (bits & 0x007fffffu) | 0x3f800000u;
+
+			float mantissa;
+			std::memcpy(&mantissa, &mantissaBits, sizeof(mantissa));
+
+			const auto t = mantissa - 1.f;
+			const auto log2Power = exponent + t * (1.42286519f + t * (-0.58208509f + t * 0.15921990f));
+
+			data[i] = decibelsPerOctave * log2Power + offset;
+		}
+	}
 };
 
 template<typename PathType>
 struct AnalyzerPathGenerator {
+	/** Reserves the envelope for the largest FFT, so a change of order never allocates. Not real-time safe. */
+	void prepare(int maxNumBins) {
+		envelopeData.reserve(static_cast<size_t>(maxNumBins));
+		resampledEnvelope.reserve(static_cast<size_t>(maxNumBins));
+	}
+
+	/*
+	Folds the numBins bins of 'renderData[]' into the envelope the path is drawn from.
+	A rise closes 'attack' of the gap at once, a fall drops at most 'decay' dB, so the
+	caller sets the ballistics for however much audio this frame stands for.
+	*/
+	void updateEnvelope(const float *renderData, int numBins, float attack, float decay, float negativeInfinity) {
+		if (envelopeData.size() != static_cast<size_t>(numBins))
+			resizeEnvelope(numBins, negativeInfinity);
+
+		for (int binNum = 0; binNum < numBins; ++binNum) {
+			float inputVal = renderData[binNum];
+			float &env = envelopeData[static_cast<size_t>(binNum)];
+
+			if (inputVal > env) {
+				env += (inputVal - env) * attack;
+			} else {
+				env -= decay;
+				env = std::max(env, inputVal); // don't decay below actual value
+			}
+		}
+	}
+
 	/*
-	converts 'renderData[]' into a juce::Path
+	converts the fftSize / 2 bins of the envelope into a juce::Path, one point per pixel column.
+	Which bins land in which column only changes with the width, the FFT size or the sample rate,
+	so that's worked out once into a table and every frame is a single pass over the columns.
 	*/
 	void generatePath(
-		const std::vector<float> &renderData,
 		juce::Rectangle<float> fftBounds,
 		int fftSize,
 		float binWidth,
 		float negativeInfinity
 	) {
-		if (envelopeData.size() != renderData.size())
-			envelopeData = std::vector<float>(renderData.size(), negativeInfinity);
+		int numBins = static_cast<int>(fftSize) / 2;
+
+		if (envelopeData.size() != static_cast<size_t>(numBins))
+			resizeEnvelope(numBins, negativeInfinity);
 
 		auto top = fftBounds.getY();
 		auto bottom = fftBounds.getBottom();
 		auto width = fftBounds.getWidth();
 
-		int numBins = static_cast<int>(fftSize) / 2;
+		const int numColumns = juce::jmax(1, juce::roundToInt(width));
 
-		PathType p;
+		if (numColumns != static_cast<int>(columns.size()) || numBins != mappedNumBins || binWidth != mappedBinWidth)
+			buildColumnTable(numColumns, numBins, binWidth);
 
-		p.preallocateSpace(3 * static_cast<int>(fftBounds.getWidth()) + 2); // Maybe add 2 more slots for the new dots?
+		// Build straight into the fifo slot. If the fifo is full, build into a path nobody will see.
+		auto *slot = pathFifo.acquireWrite();
+		PathType &p = slot != nullptr ? *slot : droppedPath;
 
-		auto map = [bottom, top, negativeInfinity](float v) {
-			return juce::jmap(
-				v,
-				negativeInfinity, 0.f,
-				bottom, top); // In the original implementation by Matkat Music, the bottom was (float)bottom, but bottom is already a float. So should I do the same?
-			};
-		auto y = map(envelopeData[0]);
+		p.clear();
+		p.preallocateSpace(3 * numColumns + 12);
 
-		jassert(!std::isnan(y) && !std::isinf(y));
+		// -inf dB sits on the bottom, 0 dB on the top.
+		const auto pixelsPerDb = (top - bottom) / (0.f - negativeInfinity);
+		const auto *envelope = envelopeData.data();
 
 		p.startNewSubPath(0, bottom);
-		p.lineTo(0, y);
 
-		for (int binNum = 1; binNum < numBins;) {
-			int pathResolution = juce::jmap<int>(binNum, 0, numBins, 2, 20);
-
-			float inputVal = renderData[binNum];
-			float &env = envelopeData[binNum];
+		for (int x = 0; x < numColumns; ++x) {
+			const auto &column = columns[static_cast<size_t>(x)];
+			float level;
 
-			if (inputVal > env) {
-				env += (inputVal - env) * 0.5f; // This will make the bin to snap insantly
+			if (column.numBins > 0) {
+				level = *std::max_element(envelope + column.firstBin, envelope + column.firstBin + column.numBins);
 			} else {
-				env -= 0.85f; // decay per frame (in dB)
-				env = std::max(env, inputVal); // don't decay below actual value
+				const auto below = envelope[column.firstBin];
+				level = below + (envelope[column.firstBin + 1] - below) * column.fraction;
 			}
 
-			auto y = map(env);
+			const auto y = bottom + (level - negativeInfinity) * pixelsPerDb;
 
 			jassert(!std::isnan(y) && !std::isinf(y));
 
-			if (!std::isnan(y) && !std::isinf(y)) {
-				auto binFreq = binNum * binWidth;
-				auto normalizedBinX = juce::mapFromLog10(binFreq, 20.f, 20000.f);
-				int binX = std::floor(normalizedBinX * width);
-
-				// Next point	
-				int nextI = binNum + pathResolution;
-				if (nextI >= numBins) {
-					p.lineTo(binX, y);
-				} else {
-					float nextVal = envelopeData[nextI];
-					float nextY = map(nextVal);
-					float nextFreq = nextI * binWidth;
-					auto nextNormalizedBinX = juce::mapFromLog10(nextFreq, 20.f, 20000.f);
-					int nextBinX = std::floor(nextNormalizedBinX * width);
-
-					float midX = (binX + nextBinX) * 0.5f;
-					float midY = (y + nextY) * 0.5f;
-
-					p.quadraticTo(binX, y, midX, midY);
-				}
-			}
-			binNum += pathResolution;
+			p.lineTo(static_cast<float>(x), y);
 		}
+
 		p.lineTo(width + 30.f, bottom);
 		p.closeSubPath();
 
-		pathFifo.push(p);
+		if (slot != nullptr)
+			pathFifo.commitWrite();
 	}
 
 	int getNumPathsAvailable() const {
 		return pathFifo.getNumAvailableForReading();
 	}
 
-	bool getPath(PathType &path) {
-		return pathFifo.pull(path);
+	/*
+	Swaps the newest finished path into path and drops any older ones.
+	The old contents of path go back into the fifo, so the slot keeps its storage for the next frame.
+	*/
+	bool swapLatestPath(PathType &path) {
+		bool gotOne = false;
+
+		while (auto *slot = pathFifo.acquireRead()) {
+			if (pathFifo.getNumAvailableForReading() == 1) {
+				path.swapWithPath(*slot);
+				gotOne = true;
+			}
+
+			pathFifo.release();
+		}
+
+		return gotOne;
 	}
 
 private:
 	Fifo<PathType> pathFifo;
-	std::vector<float> envelopeData;
+	PathType droppedPath;
+	std::vector<float> envelopeData, resampledEnvelope;
+
+	/*
+	The bins under one pixel column. Above a few hundred Hz a column covers several bins and shows
+	the loudest of them, so narrow peaks survive. Lower down the bins are wider than a pixel, so a
+	column has none of its own and interpolates between the two around its centre instead.
+	*/
+	struct Column {
+		int firstBin;
+		int numBins;
+		float fraction;
+	};
+
+	std::vector<Column> columns;
+	int mappedNumBins{ 0 };
+	float mappedBinWidth{ 0.f };
+
+	void buildColumnTable(int numColumns, int numBins, float binWidth) {
+		columns.resize(static_cast<size_t>(numColumns));
+		mappedNumBins = numBins;
+		mappedBinWidth = binWidth;
+
+		// No rate yet means no frequencies to map, so park every column on the lowest bins.
+		if (!(binWidth > 0.f)) {
+			std::fill(columns.begin(), columns.end(), Column{ 0, 0, 0.f });
+			return;
+		}
+
+		for (int x = 0; x < numColumns; ++x) {
+			const auto lowBin = juce::mapToLog10(static_cast<float>(x) / static_cast<float>(numColumns), 20.f, 20000.f) / binWidth;
+			const auto highBin = juce::mapToLog10(static_cast<float>(x + 1) / static_cast<float>(numColumns), 20.f, 20000.f) / binWidth;
+
+			// The bins whose centres fall in [lowBin, highBin), minus any past Nyquist.
+			const int first = juce::jlimit(0, numBins, static_cast<int>(std::ceil(lowBin)));
+			const int last = juce::jlimit(0, numBins, static_cast<int>(std::ceil(highBin)));
+
+			auto &column = columns[static_cast<size_t>(x)];
+
+			if (last > first) {
+				column = { first, last - first, 0.f };
+			} else {
+				const auto centre = 0.5f * (lowBin + highBin);
+				const int below = juce::jlimit(0, numBins - 2, static_cast<int>(std::floor(centre)));
+
+				column = { below, 0, juce::jlimit(0.f, 1.f, centre - static_cast<float>(below)) };
+			}
+		}
+	}
+
+	/*
+	Carries the envelope over to a new number of bins, so the curve doesn't drop to the floor and
+	climb back when the FFT order changes. Each new bin takes the loudest old bin it covers.
+	*/
+	void resizeEnvelope(int numBins, float negativeInfinity) {
+		const int oldNumBins = static_cast<int>(envelopeData.size());
+
+		if (oldNumBins == 0) {
+			envelopeData.assign(static_cast<size_t>(numBins), negativeInfinity);
+			return;
+		}
+
+		resampledEnvelope.resize(static_cast<size_t>(numBins));
+
+		for (int k = 0; k < numBins; ++k) {
+			const int first = static_cast<int>(static_cast<juce::int64>(k) * oldNumBins / numBins);
+			const int last = juce::jmax(first + 1, static_cast<int>(static_cast<juce::int64>(k + 1) * oldNumBins / numBins));
+
+			resampledEnvelope[static_cast<size_t>(k)] = *std::max_element(envelopeData.begin() + first, envelopeData.begin() + last);
+		}
 
+		envelopeData.swap(resampledEnvelope);
+	}
 };
 
 struct LookAndFeel: juce::LookAndFeel_V4 {
@@ -210,6 +423,26 @@ struct LookAndFeel: juce::LookAndFeel_V4 {
 
 private:
 	float lineW = 3.0f;
+
+	/*
+	The parts of a knob that don't depend on its value: the range arc underneath the value arc,
+	and the shadowed, gradient-filled body on top of it. Rendered once per knob size and display scale.
+	*/
+	struct KnobLayers {
+		juce::Rectangle<float> bounds;
+		float scale;
+		float rotaryStartAngle, rotaryEndAngle;
+		juce::Rectangle<float> area;
+		juce::Image track, body;
+	};
+
+	static constexpr size_t maxCachedKnobs = 8;
+	std::vector<KnobLayers> knobCache;
+
+	const KnobLayers &getKnobLayers(juce::Rectangle<float> bounds,
+									float rotaryStartAngle,
+									float rotaryEndAngle,
+									float scale);
 };
 
 struct RotarySliderWithLabels: juce::Slider {
@@ -220,7 +453,7 @@ struct RotarySliderWithLabels: juce::Slider {
 		param(&rap),
 		suffix(unitSuffix),
 		name(displayName) {
-		setLookAndFeel(&lnf);
+		setLookAndFeel(&lnf.getObject());
 	}
 
 	~RotarySliderWithLabels() {
@@ -239,8 +472,15 @@ struct RotarySliderWithLabels: juce::Slider {
 	int getTextHeight() const { return 14; };
 	juce::String getDisplayString() const;
 	juce::String getName() const;
+
+	/** Points the readout at another parameter with the same range, e.g. when the peak card switches bands. */
+	void setParameter(juce::RangedAudioParameter &rap) {
+		param = &rap;
+		repaint();
+	}
 private:
-	LookAndFeel lnf;
+	// One look-and-feel, and so one knob cache, for every knob in every editor.
+	juce::SharedResourcePointer<LookAndFeel> lnf;
 
 	juce::RangedAudioParameter *param;
 	juce::String suffix;
@@ -259,8 +499,7 @@ struct ControlsContainer: public juce::Component {
 		addAndMakeVisible(knob);
 
 		auto label = rswlNameList.add(new juce::Label(knob->getName() + " Title", knob->getName()));
-		static juce::Font knobNameFont(FontManager::inter(knobLabelHeight, regular));
-		label->setFont(knobNameFont);
+		label->setFont(FontManager::inter(knobLabelHeight, regular));
 		label->setColour(juce::Label::textColourId, Palette::TextColour);
 		label->setJustificationType(juce::Justification::centred);
 		addAndMakeVisible(*label);
@@ -291,28 +530,114 @@ private:
 	const int CardNameTextHeight = 30;
 };
 
+using AnalyzerPaths = std::array<juce::Path, numAnalyzerViews>;
+
+/*
+Both channels' taps through one stereo FFTDataGenerator, and a path per view.
+Both taps are filled from the same blocks, so one read position serves both.
+
+The stereo buffer always holds the newest samples for the largest FFT, and each frame takes the
+tail it needs. So the order can change between two frames without waiting for the buffer to refill.
+
+Frames sit on a hop set by the overlap, not by the host's block size. Each call computes at
+most the few newest frames still due and builds one path per view from them, so the cost per
+display frame is bounded whatever the sample rate or buffer size.
+*/
 struct PathProducer {
 
-	PathProducer(SingleChannelSampleFifo<SimpleEQAudioProcessor::BlockType> &scsf):
-		channelFifo(&scsf) {
-		FFTDataGenerator.changeOrder(FFTOrder::order2048);
-		monoBuffer.setSize(1, FFTDataGenerator.getFFTSize());
+	PathProducer(SingleChannelSampleFifo<SimpleEQAudioProcessor::BlockType> &left,
+				 SingleChannelSampleFifo<SimpleEQAudioProcessor::BlockType> &right):
+		leftFifo(&left),
+		rightFifo(&right) {
+		FFTDataGenerator.prepare(FFTOrder::order2048);
+		stereoBuffer.setSize(2, 1 << maxFFTOrder);
+
+		for (auto &generator : pathProducers)
+			generator.prepare((1 << maxFFTOrder) / 2);
 	}
 
-	void process(juce::Rectangle<float> fftBounds, double sampleRate);
+	/**
+	Runs any new audio through the FFT and path stages at the given order and overlap. Returns true and swaps
+	the newest path of every view in enabledViews into latestPaths if there was one. The other views are cleared.
+	*/
+	bool process(juce::Rectangle<float> fftBounds, double sampleRate, FFTOrder order, float overlap, juce::uint32 enabledViews, AnalyzerPaths &latestPaths);
 
-	juce::Path getPath() { return FFTPath; }
+	// How much consecutive frames overlap. The hop is what's left of the FFT size.
+	static constexpr float defaultOverlap = 0.75f;
+	static constexpr float maxOverlap = 0.875f;
 
 private:
-	SingleChannelSampleFifo<SimpleEQAudioProcessor::BlockType> *channelFifo;
+	/*
+	The most frames computed per call; older ones due are skipped. The frames span 1.75 FFT lengths
+	at any overlap, which covers a 60 Hz display frame even for 2048 points at 192 kHz. That's four
+	frames at 75%, and seven at 87.5%.
+	*/
+	static int getMaxFramesPerUpdate(float overlap) { return 1 + static_cast<int>(std::ceil(0.75f / (1.f - overlap))); }
+
+	// Envelope ballistics, in real time, so they look the same at any hop and sample rate.
+	static constexpr float envelopeAttackHalfLifeSeconds = 0.01f;
+	static constexpr float envelopeDecayDbPerSecond = 80.f;
+
+	SingleChannelSampleFifo<SimpleEQAudioProcessor::BlockType> *leftFifo, *rightFifo;
+	juce::int64 readPosition = 0;
 
-	juce::AudioBuffer<float> monoBuffer;
+	int getHopSize(float overlap) const { return static_cast<int>(static_cast<float>(FFTDataGenerator.getFFTSize()) * (1.f - overlap)); }
+
+	juce::AudioBuffer<float> stereoBuffer;
 
 	FFTDataGenerator<std::vector<float>> FFTDataGenerator;
 
-	AnalyzerPathGenerator<juce::Path> pathProducer;
+	std::array<AnalyzerPathGenerator<juce::Path>, numAnalyzerViews> pathProducers;
+
+	/** How far both taps have been written. The right one is pushed second, so it's never ahead. */
+	juce::int64 getWritePosition() const { return juce::jmin(leftFifo->getWritePosition(), rightFifo->getWritePosition()); }
+
+	bool readStereo(juce::int64 position, int destStartSample, int numSamples);
+};
+
+/*
+Runs the stereo PathProducer on a background thread at display rate,
+so FFTs and path generation never compete with the message thread.
+
+The analysis bounds go in and the finished paths come out through TripleBuffers,
+so neither side ever waits on the other.
+*/
+struct AnalyzerThread: juce::Thread {
+	AnalyzerThread(SimpleEQAudioProcessor &p);
+	~AnalyzerThread() override;
+
+	/** Message thread: where the paths should be laid out, relative to the analysis area. */
+	void setAnalysisBounds(juce::Rectangle<float> bounds);
+
+	/** Message thread: which views to compute from now on, as getAnalyzerViewBit() flags. */
+	void setEnabledViews(juce::uint32 views) { enabledViews.store(views, std::memory_order_relaxed); }
+
+	/** Message thread: the FFT size to use from the next frame on. Every order is prepared up front, so this is cheap. */
+	void setFFTOrder(FFTOrder order) { fftOrder.store(order, std::memory_order_relaxed); }
+
+	/** Message thread: how much consecutive frames overlap from the next frame on, up to PathProducer::maxOverlap. */
+	void setOverlap(float amount) { overlap.store(juce::jlimit(0.f, PathProducer::maxOverlap, amount), std::memory_order_relaxed); }
+
+	/** Message thread: picks up any paths finished since the last call. */
+	void pullLatestPaths();
 
-	juce::Path FFTPath;
+	/** Message thread: the newest path picked up by pullLatestPaths() for that view. Empty if the view is off. */
+	const juce::Path &getPath(AnalyzerView view) const;
+
+	void run() override;
+
+private:
+	static constexpr int frameIntervalMs = 1000 / 60;
+
+	SimpleEQAudioProcessor &audioProcessor;
+
+	PathProducer pathProducer;
+	std::atomic<juce::uint32> enabledViews{ getAnalyzerViewBit(View_Left) | getAnalyzerViewBit(View_Right) };
+	std::atomic<int> fftOrder{ order2048 };
+	std::atomic<float> overlap{ PathProducer::defaultOverlap };
+
+	TripleBuffer<juce::Rectangle<float>> analysisBounds;
+	TripleBuffer<AnalyzerPaths> paths;
 };
 
 struct ResponseCurveComponent: juce::Component,
@@ -330,13 +655,25 @@ struct ResponseCurveComponent: juce::Component,
 	void paint(juce::Graphics &g) override;
 	void resized() override;
 
+	/** Which analyzer views to compute and draw, as getAnalyzerViewBit() flags. */
+	void setAnalyzerViews(juce::uint32 views);
+
+	/** The analyzer's FFT size. */
+	void setAnalyzerOrder(FFTOrder order) { analyzer.setFFTOrder(order); }
+
+	/** How much the analyzer's frames overlap. */
+	void setAnalyzerOverlap(float overlap) { analyzer.setOverlap(overlap); }
+
 private:
 	SimpleEQAudioProcessor &audioProcessor;
 	juce::Atomic<bool> parametersChanged{ false };
+	juce::uint32 analyzerViews{ 0 };
 
-	MonoChain monoChain;
+	ResponseCurveCache responseCurveCache;
+	juce::Path responseCurve;
+	juce::Rectangle<int> responseCurveArea;
 
-	void updateChain();
+	void updateResponseCurve();
 	bool isPowerOfTen(float num);
 
 	juce::Image background;
@@ -345,7 +682,7 @@ private:
 
 	juce::Rectangle<int> getAnalysisArea();
 
-	PathProducer leftPathProducer, rightPathProducer;
+	AnalyzerThread analyzer;
 
 	const int fontHeight = 14;
 };
@@ -381,17 +718,47 @@ private:
 		peakControls,
 		highCutControls;
 
+	// L, R, M and S toggles for the analyzer. The choice is saved with the plugin's state.
+	std::array<juce::TextButton, numAnalyzerViews> analyzerViewButtons;
+
+	// The analyzer's FFT size and overlap, saved with the state the same way.
+	juce::ComboBox analyzerOrderBox,
+		analyzerOverlapBox;
+
+	// Which band the peak card edits, and whether that band is on. Also saved with the state.
+	juce::ComboBox peakBandBox;
+	juce::TextButton peakBandEnabledButton{ "On" };
+
+	juce::ComboBox topologyBox,
+		designBox,
+		oversamplingBox,
+		processingModeBox;
+
+	void updateAnalyzerViews();
+	void updateAnalyzerOrder();
+	void updateAnalyzerOverlap();
+	void selectPeakBand(int band);
+
 	using APVTS = juce::AudioProcessorValueTreeState;
 	using Attachment = APVTS::SliderAttachment;
 
-	Attachment peakFreqSliderAttachment,
-		peakGainSliderAttachment,
-		peakQualitySliderAttachment,
-		lowCutFreqSliderAttachment,
+	Attachment lowCutFreqSliderAttachment,
 		highCutFreqSliderAttachment,
 		lowCutSlopeSliderAttachment,
 		highCutSlopeSliderAttachment;
 
+	// An attachment can't be moved to another parameter, so selectPeakBand() makes new ones.
+	std::unique_ptr<Attachment> peakFreqSliderAttachment,
+		peakGainSliderAttachment,
+		peakQualitySliderAttachment;
+	std::unique_ptr<APVTS::ButtonAttachment> peakBandEnabledAttachment;
+
+	// Made once the boxes hold their items, so they show the current choice from the start.
+	std::unique_ptr<APVTS::ComboBoxAttachment> topologyAttachment,
+		designAttachment,
+		oversamplingAttachment,
+		processingModeAttachment;
+
 	std::vector<juce::Component *> getComps();
 
 	const int controlCardGap = 12;
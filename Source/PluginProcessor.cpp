@@ -24,9 +24,12 @@ SimpleEQAudioProcessor::SimpleEQAudioProcessor()
 	)
 #endif
 {
+	startTimer(latencyPollIntervalMs);
 }
 
-SimpleEQAudioProcessor::~SimpleEQAudioProcessor() {}
+SimpleEQAudioProcessor::~SimpleEQAudioProcessor() {
+	stopTimer();
+}
 
 //==============================================================================
 const juce::String
@@ -95,26 +98,154 @@ void SimpleEQAudioProcessor::prepareToPlay(double sampleRate, int samplesPerBloc
 
 	spec.maximumBlockSize = samplesPerBlock;
 
-	spec.numChannels = 1;
+	// Every channel of the bus goes through one chain, channelsPerGroup of them per SIMD register.
+	spec.numChannels = static_cast<juce::uint32>(juce::jmax(getTotalNumInputChannels(), getTotalNumOutputChannels()));
 
 	spec.sampleRate = sampleRate;
+	analyzerSampleRate.store(sampleRate, std::memory_order_relaxed);
+
+	// Here the engine can be built on the spot, so a saved linear phase session starts in that mode.
+	wantsLinearPhase = linearPhase = parameterSnapshot.load().linearPhase;
+	linearPhaseEngine.prepare(sampleRate, static_cast<int>(spec.numChannels), linearPhase);
+	floatScratch.setSize(static_cast<int>(spec.numChannels), controlBlockSize);
+
+	// Hosts set the precision before calling prepareToPlay.
+	if (isUsingDoublePrecision())
+		prepareProcessingPath<double>(spec);
+	else
+		prepareProcessingPath<float>(spec);
+
+	// Designs every band from the current values, so the first tick has them in place before the first sample.
+	controlDesigner.prepare(sampleRate, controlBlockSize);
+	samplesUntilControlTick = 0;
+
+	// Hosts read the latency right after prepareToPlay(), which is allowed to report it directly.
+	setLatencySamples(pendingLatency.load());
+}
+
+template<typename SampleType>
+void SimpleEQAudioProcessor::prepareProcessingPath(const juce::dsp::ProcessSpec &spec) {
+	auto &path = getProcessingPath<SampleType>();
+	path.chain.prepare(spec);
+
+	// The caller takes a pass itself, so one worker fewer than passes is enough.
+	if (static_cast<int>(spec.numChannels) >= parallelChannelThreshold)
+		workerPool.prepare(juce::jmin(path.chain.getNumPasses(), juce::SystemStats::getNumCpus()) - 1,
+						   spec.maximumBlockSize / spec.sampleRate);
+	else
+		workerPool.release();
+
+	// The designer already ramps the parameters, so the SVFs only need to interpolate between ticks.
+	path.chain.setSmoothingSamples(controlBlockSize);
+
+	// Every factor is allocated up front, so switching between them never allocates.
+	// processSamples() never hands them more than one control period at a time.
+	auto oversampledSpec = spec;
+	oversampledSpec.sampleRate = spec.sampleRate * (1 << maxOversamplingOrder);
+	oversampledSpec.maximumBlockSize = static_cast<juce::uint32>(controlBlockSize << maxOversamplingOrder);
+	path.oversampledChain.prepare(oversampledSpec);
+
+	for (int order = 1; order <= maxOversamplingOrder; ++order) {
+		// Polyphase IIR half-bands, with a fractional delay on top so the latency is a whole number of samples.
+		auto &oversampler = path.oversamplers[static_cast<size_t>(order - 1)];
+		oversampler = std::make_unique<juce::dsp::Oversampling<SampleType>>(
+			spec.numChannels,
+			static_cast<size_t>(order),
+			juce::dsp::Oversampling<SampleType>::filterHalfBandPolyphaseIIR,
+			true,
+			true);
+		oversampler->initProcessing(static_cast<size_t>(controlBlockSize));
+	}
+
+	setOversamplingOrder<SampleType>(parameterSnapshot.load().oversamplingOrder);
+}
+
+template<typename SampleType>
+void SimpleEQAudioProcessor::setOversamplingOrder(int order) {
+	auto &path = getProcessingPath<SampleType>();
+	oversamplingOrder = juce::jlimit(0, maxOversamplingOrder, order);
+
+	if (oversamplingOrder == 0) {
+		oversamplingLatency = 0;
+		updateLatency();
+		return;
+	}
+
+	auto &oversampler = *path.oversamplers[static_cast<size_t>(oversamplingOrder - 1)];
+	oversampler.reset();
+
+	// Starts from silence, and smooths over one control period at the oversampled rate.
+	path.oversampledChain.reset();
+	path.oversampledChain.setSmoothingSamples(controlBlockSize << oversamplingOrder);
+
+	oversamplingLatency = juce::roundToInt(oversampler.getLatencyInSamples());
+	updateLatency();
+}
+
+void SimpleEQAudioProcessor::updateLatency() {
+	pendingLatency.store(linearPhase ? linearPhaseEngine.getLatencySamples() : oversamplingLatency);
+}
+
+void SimpleEQAudioProcessor::timerCallback() {
+	// setLatencySamples() only tells the host when the value actually changed.
+	setLatencySamples(pendingLatency.load());
+}
+
+template<typename SampleType>
+void SimpleEQAudioProcessor::setCoefficients(const CoefficientSet &coefficients) {
+	auto &path = getProcessingPath<SampleType>();
+
+	wantsLinearPhase = coefficients.linearPhase;
+
+	if (coefficients.oversamplingOrder != oversamplingOrder)
+		setOversamplingOrder<SampleType>(coefficients.oversamplingOrder);
 
-	leftChain.prepare(spec);
-	rightChain.prepare(spec);
-	updateFilters();
+	if (oversamplingOrder == 0) {
+		path.chain.setCoefficients(coefficients);
+		return;
+	}
+
+	// The low cut stays at the host rate, and the peaks and high cut go up with the oversampler.
+	auto lowCut = coefficients;
+	lowCut.peakEnabled = {};
+	lowCut.numHighCutStages = 0;
+	path.chain.setCoefficients(lowCut);
+
+	auto peakAndHighCut = coefficients;
+	peakAndHighCut.numLowCutStages = 0;
+	path.oversampledChain.setCoefficients(peakAndHighCut);
+}
+
+template<typename SampleType>
+void SimpleEQAudioProcessor::updateProcessingMode() {
+	const bool useLinearPhase = linearPhaseEngine.update(wantsLinearPhase);
+
+	if (useLinearPhase == linearPhase)
+		return;
 
-	leftChannelFifo.prepare(samplesPerBlock);
-	rightChannelFifo.prepare(samplesPerBlock);
+	linearPhase = useLinearPhase;
 
-	osc.initialise([](float x) { return std::sin(x); });
-	spec.numChannels = getTotalNumInputChannels();
-	osc.prepare(spec);
-	osc.setFrequency(50);
+	// The engine starts from silence by itself. The chain does the same rather than resume from history it never saw.
+	if (!linearPhase) {
+		auto &path = getProcessingPath<SampleType>();
+
+		path.chain.reset();
+		path.oversampledChain.reset();
+
+		for (auto &oversampler : path.oversamplers)
+			oversampler->reset();
+	}
+
+	updateLatency();
 }
 
 void SimpleEQAudioProcessor::releaseResources() {
 	// When playback stops, you can use this as an opportunity to free up any
 	// spare memory, etc.
+
+	workerPool.release();
+	linearPhaseEngine.release();
+	controlDesigner.release();
 }
 
 #ifndef JucePlugin_PreferredChannelConfigurations
@@ -123,11 +254,9 @@ bool SimpleEQAudioProcessor::isBusesLayoutSupported(const BusesLayout &layouts)
 	juce::ignoreUnused(layouts);
 	return true;
 #else
-	// This is the place where you check if the layout is supported.
-	// In this template code we only support mono or stereo.
-	// Some plugin hosts, such as certain GarageBand versions, will only
-	// load plugins that support stereo bus layouts.
-	if (layouts.getMainOutputChannelSet() != juce::AudioChannelSet::mono() && layouts.getMainOutputChannelSet() != juce::AudioChannelSet::stereo())
+	// The filter chain doesn't care how many channels there are, so anything from
+	// mono through surround and immersive layouts to discrete and ambisonic buses is fine.
+	if (layouts.getMainOutputChannelSet().isDisabled())
 		return false;
 
 	// This checks if the input layout matches the output layout
@@ -143,6 +272,16 @@ bool SimpleEQAudioProcessor::isBusesLayoutSupported(const BusesLayout &layouts)
 
 void SimpleEQAudioProcessor::processBlock(juce::AudioBuffer<float> &buffer,
 										  juce::MidiBuffer &midiMessages) {
+	processSamples(buffer);
+}
+
+void SimpleEQAudioProcessor::processBlock(juce::AudioBuffer<double> &buffer,
+										  juce::MidiBuffer &midiMessages) {
+	processSamples(buffer);
+}
+
+template<typename SampleType>
+void SimpleEQAudioProcessor::processSamples(juce::AudioBuffer<SampleType> &buffer) {
 	juce::ScopedNoDenormals noDenormals;
 	auto totalNumInputChannels = getTotalNumInputChannels();
 	auto totalNumOutputChannels = getTotalNumOutputChannels();
@@ -156,28 +295,96 @@ void SimpleEQAudioProcessor::processBlock(juce::AudioBuffer<float> &buffer,
 	for (auto i = totalNumInputChannels; i < totalNumOutputChannels; ++i)
 		buffer.clear(i, 0, buffer.getNumSamples());
 
-	updateFilters();
+	auto &path = getProcessingPath<SampleType>();
+
+	juce::dsp::AudioBlock<SampleType> block(buffer);
+	const int numSamples = buffer.getNumSamples();
+
+	// Split the block wherever a control tick falls. The grid carries over from one block to
+	// the next, so the same automation gives the same output whatever block size the host uses.
+	for (int start = 0; start < numSamples;) {
+		if (samplesUntilControlTick == 0) {
+			if (auto *coefficients = controlDesigner.tick(isNonRealtime()))
+				setCoefficients<SampleType>(*coefficients);
 
-	juce::dsp::AudioBlock<float> block(buffer);
+			updateProcessingMode<SampleType>();
 
-	//buffer.clear();
+			samplesUntilControlTick = controlBlockSize;
+		}
 
-	//juce::dsp::ProcessContextReplacing<float> stereoContext(block);
-	//osc.process(stereoContext);
+		const int length = juce::jmin(samplesUntilControlTick, numSamples - start);
+		auto subBlock = block.getSubBlock(static_cast<size_t>(start), static_cast<size_t>(length));
 
-	auto leftBlock = block.getSingleChannelBlock(0);
-	auto rightBlock = block.getSingleChannelBlock(1);
+		if (linearPhase) {
+			processLinearPhase(subBlock);
 
-	juce::dsp::ProcessContextReplacing<float> leftContext(leftBlock);
-	juce::dsp::ProcessContextReplacing<float> rightContext(rightBlock);
+			start += length;
+			samplesUntilControlTick -= length;
+			continue;
+		}
 
-	leftChain.process(leftContext);
-	rightChain.process(rightContext);
+		processChain(path.chain, subBlock);
+
+		// At 1x none of this runs, so it costs nothing.
+		if (oversamplingOrder > 0) {
+			auto &oversampler = *path.oversamplers[static_cast<size_t>(oversamplingOrder - 1)];
+
+			processChain(path.oversampledChain, oversampler.processSamplesUp(subBlock));
+			oversampler.processSamplesDown(subBlock);
+		}
+
+		start += length;
+		samplesUntilControlTick -= length;
+	}
 
 	leftChannelFifo.update(buffer);
 	rightChannelFifo.update(buffer);
 }
 
+template<typename SampleType>
+void SimpleEQAudioProcessor::processLinearPhase(juce::dsp::AudioBlock<SampleType> block) {
+	if constexpr (std::is_same_v<SampleType, float>) {
+		linearPhaseEngine.process(block);
+	} else {
+		// Never longer than a control period, which is what the scratch is sized for.
+		const auto numChannels = juce::jmin(block.getNumChannels(), static_cast<size_t>(floatScratch.getNumChannels()));
+		const auto numSamples = static_cast<int>(block.getNumSamples());
+
+		for (size_t ch = 0; ch < numChannels; ++ch) {
+			const auto *source = block.getChannelPointer(ch);
+			auto *destination = floatScratch.getWritePointer(static_cast<int>(ch));
+
+			for (int i = 0; i < numSamples; ++i)
+				destination[i] = static_cast<float>(source[i]);
+		}
+
+		juce::dsp::AudioBlock<float> scratchBlock(floatScratch);
+		linearPhaseEngine.process(scratchBlock.getSubsetChannelBlock(0, numChannels).getSubBlock(0, static_cast<size_t>(numSamples)));
+
+		for (size_t ch = 0; ch < numChannels; ++ch) {
+			const auto *source = floatScratch.getReadPointer(static_cast<int>(ch));
+			auto *destination = block.getChannelPointer(ch);
+
+			for (int i = 0; i < numSamples; ++i)
+				destination[i] = static_cast<double>(source[i]);
+		}
+	}
+}
+
+template<typename SampleType>
+void SimpleEQAudioProcessor::processChain(MultichannelChain<SampleType> &chain, juce::dsp::AudioBlock<SampleType> block) {
+	juce::dsp::ProcessContextReplacing<SampleType> context(block);
+
+	if (workerPool.getNumWorkers() > 0) {
+		chain.beginBlock(static_cast<int>(block.getNumSamples()));
+
+		auto processPass = [&chain, &context](int pass) { chain.processPass(context, pass); };
+		workerPool.run(chain.getNumPasses(), processPass);
+	} else {
+		chain.process(context);
+	}
+}
+
 //==============================================================================
 bool SimpleEQAudioProcessor::hasEditor() const {
 	return true; // (change this to false if you choose to not supply an editor)
@@ -206,7 +413,7 @@ void SimpleEQAudioProcessor::setStateInformation(const void *data, int sizeInByt
 	auto tree = juce::ValueTree::readFromData(data, sizeInBytes);
 	if (tree.isValid()) {
 		apvts.replaceState(tree);
-		updateFilters();
+		parameterSnapshot.invalidate();
 	}
 }
 
@@ -215,63 +422,25 @@ ChainSettings getChainSettings(juce::AudioProcessorValueTreeState &apvts) {
 
 	settings.lowCutFreq = apvts.getRawParameterValue("LowCut Freq")->load();
 	settings.highCutFreq = apvts.getRawParameterValue("HighCut Freq")->load();
-	settings.peakFreq = apvts.getRawParameterValue("Peak Freq")->load();
-	settings.peakcGainInDecibels = apvts.getRawParameterValue("Peak Gain")->load();
-	settings.peakQuality = apvts.getRawParameterValue("Peak Quality")->load();
+
+	for (int band = 0; band < maxPeakBands; ++band) {
+		auto &peak = settings.peaks[static_cast<size_t>(band)];
+		peak.freq = apvts.getRawParameterValue(getPeakParameterID(band, "Freq"))->load();
+		peak.gainInDecibels = apvts.getRawParameterValue(getPeakParameterID(band, "Gain"))->load();
+		peak.quality = apvts.getRawParameterValue(getPeakParameterID(band, "Quality"))->load();
+		peak.enabled = apvts.getRawParameterValue(getPeakParameterID(band, "Enabled"))->load() > 0.5f;
+	}
+
 	settings.lowCutSlope = static_cast<Slope>(apvts.getRawParameterValue("LowCut Slope")->load());
 	settings.highCutSlope = static_cast<Slope>(apvts.getRawParameterValue("HighCut Slope")->load());
+	settings.topology = static_cast<Topology>(apvts.getRawParameterValue("Filter Topology")->load());
+	settings.designMethod = static_cast<DesignMethod>(apvts.getRawParameterValue("Filter Design")->load());
+	settings.oversamplingOrder = static_cast<int>(apvts.getRawParameterValue("Oversampling")->load());
+	settings.linearPhase = apvts.getRawParameterValue("Processing Mode")->load() > 0.5f;
 
 	return settings;
 }
 
-Coefficients makePeakFilter(const ChainSettings &chainSettings, double sampleRate) {
-	return juce::dsp::IIR::Coefficients<float>::makePeakFilter(
-		sampleRate,
-		chainSettings.peakFreq,
-		chainSettings.peakQuality,
-		juce::Decibels::decibelsToGain(chainSettings.peakcGainInDecibels));
-}
-
-void SimpleEQAudioProcessor::updatePeakFilter(const ChainSettings &chainSettings) {
-	auto peakCoefficients = makePeakFilter(chainSettings, getSampleRate());
-
-	updateCoefficients(leftChain.get<ChainPositions::Peak>().coefficients, peakCoefficients);
-	updateCoefficients(rightChain.get<ChainPositions::Peak>().coefficients, peakCoefficients);
-}
-
-void updateCoefficients(Coefficients &old, const Coefficients &replacement) {
-	*old = *replacement;
-}
-
-void SimpleEQAudioProcessor::updateLowCutFilters(const ChainSettings &chainSettings) {
-	auto lowCutCoefficients = makeLowCutFilter(chainSettings, getSampleRate());
-
-	auto &leftLowCut = leftChain.get<ChainPositions::LowCut>();
-	auto &rightLowCut = rightChain.get<ChainPositions::LowCut>();
-
-	updateCutFilter(leftLowCut, lowCutCoefficients, chainSettings.lowCutSlope);
-	updateCutFilter(rightLowCut, lowCutCoefficients, chainSettings.lowCutSlope);
-}
-
-void SimpleEQAudioProcessor::updateHighCutFilters(const ChainSettings &chainSettings) {
-	auto highCutCoefficients = makeHighCutFilter(chainSettings, getSampleRate());
-
-	auto &leftHighCut = leftChain.get<ChainPositions::HighCut>();
-	auto &rightHighCut = rightChain.get<ChainPositions::HighCut>();
-
-	updateCutFilter(leftHighCut, highCutCoefficients, chainSettings.highCutSlope);
-	updateCutFilter(rightHighCut, highCutCoefficients, chainSettings.highCutSlope);
-}
-
-void SimpleEQAudioProcessor::updateFilters() {
-	auto chainSettings = getChainSettings(apvts);
-
-	updateLowCutFilters(chainSettings);
-	updatePeakFilter(chainSettings);
-	updateHighCutFilters(chainSettings);
-}
-
-
 juce::AudioProcessorValueTreeState::ParameterLayout
 SimpleEQAudioProcessor::createParameterLayout() {
 	juce::AudioProcessorValueTreeState::ParameterLayout layout;
@@ -288,23 +457,39 @@ SimpleEQAudioProcessor::createParameterLayout() {
 		juce::NormalisableRange<float>(20.f, 20000.f, 0.001f, 0.25f),
 		20000.f));
 
-	layout.add(std::make_unique<juce::AudioParameterFloat>(
-		"Peak Freq",
-		"Peak Freq",
-		juce::NormalisableRange<float>(20.f, 20000.f, 0.001f, 0.25f),
-		750.f));
-
-	layout.add(std::make_unique<juce::AudioParameterFloat>(
-		"Peak Gain",
-		"Peak Gain",
-		juce::NormalisableRange<float>(-24.f, 24.f, 0.5f, 1.f),
-		0.0f));
-
-	layout.add(std::make_unique<juce::AudioParameterFloat>(
-		"Peak Quality",
-		"Peak Quality",
-		juce::NormalisableRange<float>(0.1f, 10.f, 0.05f, 1.f),
-		1.f));
+	// The same four parameters for every peak band. Only the first is on by default, where the
+	// single peak used to be. The others start spread out over the spectrum, ready to be switched on.
+	constexpr float defaultPeakFreqs[maxPeakBands] = { 750.f, 60.f, 150.f, 350.f, 1500.f, 3000.f, 6000.f, 12000.f };
+
+	for (int band = 0; band < maxPeakBands; ++band) {
+		const auto freqID = getPeakParameterID(band, "Freq");
+		const auto gainID = getPeakParameterID(band, "Gain");
+		const auto qualityID = getPeakParameterID(band, "Quality");
+		const auto enabledID = getPeakParameterID(band, "Enabled");
+
+		layout.add(std::make_unique<juce::AudioParameterFloat>(
+			freqID,
+			freqID,
+			juce::NormalisableRange<float>(20.f, 20000.f, 0.001f, 0.25f),
+			defaultPeakFreqs[band]));
+
+		layout.add(std::make_unique<juce::AudioParameterFloat>(
+			gainID,
+			gainID,
+			juce::NormalisableRange<float>(-24.f, 24.f, 0.5f, 1.f),
+			0.0f));
+
+		layout.add(std::make_unique<juce::AudioParameterFloat>(
+			qualityID,
+			qualityID,
+			juce::NormalisableRange<float>(0.1f, 10.f, 0.05f, 1.f),
+			1.f));
+
+		layout.add(std::make_unique<juce::AudioParameterBool>(
+			enabledID,
+			enabledID,
+			band == 0));
+	}
 
 	constexpr const char *filterSlopeChoices[] = {
 		"12 db/Oct", "24 db/Oct", "36 db/Oct", "48 db/Oct"
@@ -324,6 +509,38 @@ SimpleEQAudioProcessor::createParameterLayout() {
 		stringArray,
 		0));
 
+	// Biquads get new coefficients once per block. The smoothed SVFs glide to them sample by sample,
+	// which is what you want under automation, at the cost of a few more operations per sample.
+	layout.add(std::make_unique<juce::AudioParameterChoice>(
+		"Filter Topology",
+		"Filter Topology",
+		juce::StringArray{ "Biquad", "Smoothed SVF" },
+		0));
+
+	// Bilinear designs cramp towards Nyquist. Magnitude matched ones follow the analog curve all the
+	// way up at the host rate, which is most of what oversampling buys at none of its cost.
+	layout.add(std::make_unique<juce::AudioParameterChoice>(
+		"Filter Design",
+		"Filter Design",
+		juce::StringArray{ "Bilinear", "Magnitude Matched" },
+		0));
+
+	// Runs the peaks and high cut at a multiple of the host rate, so they keep their shape near Nyquist.
+	// The low cut stays at the host rate, where its poles are easier to represent.
+	layout.add(std::make_unique<juce::AudioParameterChoice>(
+		"Oversampling",
+		"Oversampling",
+		juce::StringArray{ "1x", "2x", "4x", "8x" },
+		0));
+
+	// Linear phase runs the same curve as one long FIR, for mastering and stem work where phase
+	// matters more than latency. The FIR is half its length late, and the host is told so.
+	layout.add(std::make_unique<juce::AudioParameterChoice>(
+		"Processing Mode",
+		"Processing Mode",
+		juce::StringArray{ "Zero Latency", "Linear Phase" },
+		0));
+
 	return layout;
 }
 
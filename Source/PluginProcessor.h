@@ -11,6 +11,15 @@
 #include <JuceHeader.h>
 
 #include <array>
+
+#include "LockFree.h"
+#include "ParameterSnapshot.h"
+#include "CoefficientDesign.h"
+#include "ControlRateDesigner.h"
+#include "LinearPhaseEngine.h"
+#include "MultichannelChain.h"
+#include "RealtimeWorkerPool.h"
+
 template<typename T>
 struct Fifo {
 	void prepare(int numChannels, int numSamples) {
@@ -60,6 +69,30 @@ struct Fifo {
 		return false;
 	}
 
+	//==============================================================================
+	/*
+	Zero-copy access. The producer fills a reserved slot in place and commits it,
+	the consumer reads the oldest slot in place and releases it. Same SPSC rules as push/pull.
+	*/
+
+	/** The slot to write into, or nullptr if the fifo is full. Must be followed by commitWrite(). */
+	T *acquireWrite() {
+		int start1, size1, start2, size2;
+		fifo.prepareToWrite(1, start1, size1, start2, size2);
+		return size1 > 0 ? &buffers[start1] : nullptr;
+	}
+
+	void commitWrite() { fifo.finishedWrite(1); }
+
+	/** The oldest unread slot, or nullptr if there is none. Must be followed by release(). */
+	T *acquireRead() {
+		int start1, size1, start2, size2;
+		fifo.prepareToRead(1, start1, size1, start2, size2);
+		return size1 > 0 ? &buffers[start1] : nullptr;
+	}
+
+	void release() { fifo.finishedRead(1); }
+
 	int getNumAvailableForReading() const {
 		return fifo.getNumReady();
 	}
@@ -70,151 +103,71 @@ private:
 };
 
 enum Channel {
-	Right,	// effectively 0
-	Left	// effectively 1
+	Left,	// effectively 0
+	Right	// effectively 1
 };
 
+/*
+Taps one channel of the processed audio for the analyzer.
+
+update() copies the whole block into a SampleRing in one go, and the analyzer reads it back
+by sample position at whatever hop size it wants. The ring is sized once for the analyzer,
+never for the host's block size, so variable block sizes can't make the audio thread reallocate.
+*/
 template<typename BlockType>
 struct SingleChannelSampleFifo {
 	SingleChannelSampleFifo(Channel ch): channelToUse(ch) {
-		prepared.set(false);
+		ring.prepare(capacity);
 	}
 
 	void update(const BlockType &buffer) {
-		jassert(prepared.get());
-		//jassert(buffer.get);
-		auto *channelPtr = buffer.getReadPointer(channelToUse);
-
-		for (int i = 0; i < buffer.getNumSamples(); ++i) {
-			pushNextSampleIntoFifo(channelPtr[i]);
-		}
-	}
+		if (buffer.getNumChannels() == 0)
+			return;
 
-	void prepare(int bufferSize) {
-		prepared.set(false);
-		size.set(bufferSize);
-
-		bufferToFill.setSize(
-			1,				//channel
-			bufferSize,		//num samples
-			false,			//keepExistingContent
-			true,			//clear extra space
-			true			//avoid reallocating
-		);
-
-		audioBufferFifo.prepare(1, bufferSize);
-		fifoIndex = 0;
-		prepared.set(true);
+		// A mono bus only has channel 0, so both taps read that.
+		const int channel = channelToUse < buffer.getNumChannels() ? channelToUse : 0;
+		ring.push(buffer.getReadPointer(channel), buffer.getNumSamples());
 	}
-	//==============================================================================
-	int getNumCompleteBuffersAvailable() const { return audioBufferFifo.getNumAvailableForReading(); }
-	bool isPrepared() const { return prepared.get(); }
-	int getSize() const { return size.get(); }
-	//==============================================================================
-	bool getAudioBuffer(BlockType &buf) { return audioBufferFifo.pull(buf); }
-private:
-	Channel channelToUse;
-	int fifoIndex = 0;
-	Fifo<BlockType> audioBufferFifo;
-	BlockType bufferToFill;
-	juce::Atomic<bool> prepared = false;
-	juce::Atomic<int> size = 0;
 
-	void pushNextSampleIntoFifo(float sample) {
-		if (fifoIndex == bufferToFill.getNumSamples()) {
-			auto ok = audioBufferFifo.push(bufferToFill);
+	/** The double precision path. The analyzer works in float, so this converts a chunk at a time on the stack. */
+	void update(const juce::AudioBuffer<double> &buffer) {
+		if (buffer.getNumChannels() == 0)
+			return;
 
-			juce::ignoreUnused(ok);
+		const int channel = channelToUse < buffer.getNumChannels() ? channelToUse : 0;
+		const auto *source = buffer.getReadPointer(channel);
 
-			fifoIndex = 0;
-		}
+		std::array<float, 256> converted;
 
-		bufferToFill.setSample(0, fifoIndex, sample);
-		++fifoIndex;
-	}
-};
+		for (int start = 0; start < buffer.getNumSamples(); start += static_cast<int>(converted.size())) {
+			const int length = juce::jmin(static_cast<int>(converted.size()), buffer.getNumSamples() - start);
 
-enum Slope {
-	Slope_12,
-	Slope_24,
-	Slope_36,
-	Slope_48
-};
+			for (int i = 0; i < length; ++i)
+				converted[static_cast<size_t>(i)] = static_cast<float>(source[start + i]);
 
-struct ChainSettings {
-	float peakFreq{ 0 }, peakcGainInDecibels{ 0 }, peakQuality{ 1.f };
-	float lowCutFreq{ 0 }, highCutFreq{ 0 };
+			ring.push(converted.data(), length);
+		}
+	}
+	//==============================================================================
+	juce::int64 getWritePosition() const { return ring.getWritePosition(); }
+	int getCapacity() const { return ring.getCapacity(); }
+	//==============================================================================
+	bool read(juce::int64 position, float *dest, int numSamples) const { return ring.read(position, dest, numSamples); }
+private:
+	// Comfortably more than the largest analyzer FFT (8192) plus a few frames of backlog.
+	static constexpr int capacity = 1 << 15;
 
-	Slope lowCutSlope{ Slope::Slope_12 }, highCutSlope{ Slope::Slope_12 };
+	Channel channelToUse;
+	SampleRing ring;
 };
 
 ChainSettings getChainSettings(juce::AudioProcessorValueTreeState &apvts);
 
-using Filter = juce::dsp::IIR::Filter<float>;
-using CutFilter = juce::dsp::ProcessorChain<Filter, Filter, Filter, Filter>;
-using MonoChain = juce::dsp::ProcessorChain<CutFilter, Filter, CutFilter>;
-
-enum ChainPositions {
-	LowCut,
-	Peak,
-	HighCut
-};
-
-using Coefficients = Filter::CoefficientsPtr;
-void updateCoefficients(Coefficients &old, const Coefficients &replacement);
-
-Coefficients makePeakFilter(const ChainSettings &chainSettings, double sampleRate);
-
-template<int Index, typename ChainType, typename CoefficientType>
-void update(ChainType &chain, const CoefficientType &coefficients) {
-	updateCoefficients(chain.template get<Index>().coefficients, coefficients[Index]);
-	chain.template setBypassed<Index>(false);
-
-}
-
-template<typename ChainType, typename CoefficientType>
-void updateCutFilter(
-	ChainType &chain,
-	const CoefficientType &coefficients,
-	const Slope &cutSlope
-) {
-
-	chain.template setBypassed<0>(true);
-	chain.template setBypassed<1>(true);
-	chain.template setBypassed<2>(true);
-	chain.template setBypassed<3>(true);
-
-	switch (cutSlope) {
-		case Slope_48:
-			update<3>(chain, coefficients);
-		case Slope_36:
-			update<2>(chain, coefficients);
-		case Slope_24:
-			update<1>(chain, coefficients);
-		case Slope_12:
-			update<0>(chain, coefficients);
-			break;
-	}
-}
-
-inline auto makeLowCutFilter(const ChainSettings &chainSettings, double sampleRate) {
-	return juce::dsp::FilterDesign<float>::designIIRHighpassHighOrderButterworthMethod(
-		chainSettings.lowCutFreq,
-		sampleRate,
-		((chainSettings.lowCutSlope + 1) * 2));
-}
-
-inline auto makeHighCutFilter(const ChainSettings &chainSettings, double sampleRate) {
-	return juce::dsp::FilterDesign<float>::designIIRLowpassHighOrderButterworthMethod(
-		chainSettings.highCutFreq,
-		sampleRate,
-		((chainSettings.highCutSlope + 1) * 2));
-}
-
 //==============================================================================
 /**
  */
-class SimpleEQAudioProcessor: public juce::AudioProcessor {
+class SimpleEQAudioProcessor: public juce::AudioProcessor,
+	private juce::Timer {
 public:
 	//==============================================================================
 	SimpleEQAudioProcessor();
@@ -229,6 +182,9 @@ public:
 #endif
 
 	void processBlock(juce::AudioBuffer<float> &, juce::MidiBuffer &) override;
+	void processBlock(juce::AudioBuffer<double> &, juce::MidiBuffer &) override;
+
+	bool supportsDoublePrecisionProcessing() const override { return true; }
 
 	//==============================================================================
 	juce::AudioProcessorEditor *createEditor() override;
@@ -255,23 +211,99 @@ public:
 
 	static juce::AudioProcessorValueTreeState::ParameterLayout createParameterLayout();
 
+	// Parameter changes land on a fixed grid of this many samples, whatever the host's block size.
+	static constexpr int controlBlockSize = 32;
+
+	// The peaks and high cut can run at up to 2^maxOversamplingOrder times the host rate.
+	static constexpr int maxOversamplingOrder = 3;
+
 	juce::AudioProcessorValueTreeState apvts{ *this, nullptr, "Parameters", createParameterLayout() };
 
 	using BlockType = juce::AudioBuffer<float>;
 	SingleChannelSampleFifo<BlockType> leftChannelFifo{ Channel::Left };
 	SingleChannelSampleFifo<BlockType> rightChannelFifo{ Channel::Right };
 
+	/** The rate of the audio in the fifos, or 0 before the first prepareToPlay(). Safe from any thread. */
+	double getAnalyzerSampleRate() const { return analyzerSampleRate.load(std::memory_order_relaxed); }
+
 private:
-	MonoChain leftChain, rightChain;
+	// getSampleRate() is a plain double written by prepareToPlay(), so other threads read this copy instead.
+	std::atomic<double> analyzerSampleRate{ 0.0 };
+
+	/*
+	Everything that runs at one processing precision. Without oversampling, chain runs every band and
+	the rest sits idle. With it, chain only runs the low cut, and the peaks and high cut run in
+	oversampledChain, between the up and down sampling of the selected stage.
+	*/
+	template<typename SampleType>
+	struct ProcessingPath {
+		MultichannelChain<SampleType> chain, oversampledChain;
+		std::array<std::unique_ptr<juce::dsp::Oversampling<SampleType>>, maxOversamplingOrder> oversamplers;
+	};
+
+	// Only the one matching the host's processing precision is prepared and used.
+	ProcessingPath<float> floatPath;
+	ProcessingPath<double> doublePath;
+
+	template<typename SampleType>
+	ProcessingPath<SampleType> &getProcessingPath() {
+		if constexpr (std::is_same_v<SampleType, double>)
+			return doublePath;
+		else
+			return floatPath;
+	}
+
+	int oversamplingOrder{ 0 }, oversamplingLatency{ 0 };
+
+	template<typename SampleType>
+	void prepareProcessingPath(const juce::dsp::ProcessSpec &spec);
+
+	template<typename SampleType>
+	void setOversamplingOrder(int order);
+
+	template<typename SampleType>
+	void setCoefficients(const CoefficientSet &coefficients);
+
+	template<typename SampleType>
+	void updateProcessingMode();
+
+	template<typename SampleType>
+	void processSamples(juce::AudioBuffer<SampleType> &buffer);
+
+	template<typename SampleType>
+	void processLinearPhase(juce::dsp::AudioBlock<SampleType> block);
+
+	/*
+	The latency changes on the audio thread, but setLatencySamples() tells the host under the
+	processor's listener lock, so the new value goes through pendingLatency to the message thread.
+	A timer polls it there, since even posting a message from the audio thread can lock or allocate.
+	*/
+	std::atomic<int> pendingLatency{ 0 };
+	static constexpr int latencyPollIntervalMs = 50;
+
+	void updateLatency();
+	void timerCallback() override;
+
+	template<typename SampleType>
+	void processChain(MultichannelChain<SampleType> &chain, juce::dsp::AudioBlock<SampleType> block);
+
+	// Buses at least this wide split the chain's passes across a worker pool, narrower ones stay on the audio thread.
+	static constexpr int parallelChannelThreshold = 32;
+	RealtimeWorkerPool workerPool;
+
+	ParameterSnapshot parameterSnapshot{ apvts };
 
-	void updatePeakFilter(const ChainSettings &chainSettings);
+	// New coefficients are taken up every controlBlockSize samples, counted from the start of playback.
+	ControlRateDesigner controlDesigner{ parameterSnapshot };
+	int samplesUntilControlTick{ 0 };
 
-	void updateLowCutFilters(const ChainSettings &chainSettings);
-	void updateHighCutFilters(const ChainSettings &chainSettings);
+	// Replaces both chains while it's on. It only runs in float, so doubles go through floatScratch.
+	LinearPhaseEngine linearPhaseEngine{ parameterSnapshot };
+	juce::AudioBuffer<float> floatScratch;
 
-	void updateFilters();
+	// What the parameters ask for, and what's actually running. The IIR chain carries on until the engine is ready.
+	bool wantsLinearPhase{ false }, linearPhase{ false };
 
-	juce::dsp::Oscillator<float> osc;
 	//==============================================================================
 	JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SimpleEQAudioProcessor)
 };
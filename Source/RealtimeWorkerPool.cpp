@@ -0,0 +1,195 @@
+/*
+  ==============================================================================
+
+	RealtimeWorkerPool.cpp
+	Created: 16 Oct 2026 10:20:00pm
+	Author:  roeim
+
+  ==============================================================================
+*/
+
+#include "RealtimeWorkerPool.h"
+
+#include <cerrno>
+
+#if JUCE_INTEL
+ #include <immintrin.h>
+#endif
+
+#if JUCE_WINDOWS
+ #include <windows.h>
+#endif
+
+namespace {
+	/** Tells the core we're spinning, so it can save power and let a hyperthread sibling run. */
+	inline void spinPause() noexcept {
+	   #if JUCE_INTEL
+		_mm_pause();
+	   #elif JUCE_ARM && JUCE_MSVC
+		__yield();
+	   #elif JUCE_ARM
+		__asm__ __volatile__("yield");
+	   #endif
+	}
+}
+
+//==============================================================================
+#if JUCE_MAC || JUCE_IOS
+RealtimeWorkerPool::Semaphore::Semaphore(): semaphore(dispatch_semaphore_create(0)) {}
+RealtimeWorkerPool::Semaphore::~Semaphore() { dispatch_release(semaphore); }
+void RealtimeWorkerPool::Semaphore::post() { dispatch_semaphore_signal(semaphore); }
+void RealtimeWorkerPool::Semaphore::wait() { dispatch_semaphore_wait(semaphore, DISPATCH_TIME_FOREVER); }
+#elif JUCE_WINDOWS
+RealtimeWorkerPool::Semaphore::Semaphore(): semaphore(CreateSemaphoreW(nullptr, 0, LONG_MAX, nullptr)) {}
+RealtimeWorkerPool::Semaphore::~Semaphore() { CloseHandle(semaphore); }
+void RealtimeWorkerPool::Semaphore::post() { ReleaseSemaphore(semaphore, 1, nullptr); }
+void RealtimeWorkerPool::Semaphore::wait() { WaitForSingleObject(semaphore, INFINITE); }
+#else
+RealtimeWorkerPool::Semaphore::Semaphore() { sem_init(&semaphore, 0, 0); }
+RealtimeWorkerPool::Semaphore::~Semaphore() { sem_destroy(&semaphore); }
+void RealtimeWorkerPool::Semaphore::post() { sem_post(&semaphore); }
+
+void RealtimeWorkerPool::Semaphore::wait() {
+	// A signal handler can interrupt the wait without a post.
+	while (sem_wait(&semaphore) != 0 && errno == EINTR) {}
+}
+#endif
+
+//==============================================================================
+RealtimeWorkerPool::Worker::Worker(RealtimeWorkerPool &owner, int index):
+	juce::Thread("SimpleEQ Worker " + juce::String(index)),
+	pool(owner) {}
+
+RealtimeWorkerPool::Worker::~Worker() {
+	stop();
+}
+
+void RealtimeWorkerPool::Worker::stop() {
+	signalThreadShouldExit();
+	wake();
+	stopThread(1000);
+}
+
+void RealtimeWorkerPool::Worker::wake() {
+	if (parked.exchange(false))
+		wakeUp.post();
+}
+
+void RealtimeWorkerPool::Worker::run() {
+	// The jobs are the same filter passes the audio thread runs, and their tails decay just as far.
+	juce::ScopedNoDenormals noDenormals;
+
+	auto seenBatch = pool.batch.load(std::memory_order_acquire);
+
+	while (!threadShouldExit()) {
+		const auto idleSince = juce::Time::getHighResolutionTicks();
+		const auto spinTicks = pool.spinTicks.load(std::memory_order_relaxed);
+
+		while (pool.batch.load(std::memory_order_acquire) == seenBatch) {
+			if (threadShouldExit())
+				return;
+
+			if (juce::Time::getHighResolutionTicks() - idleSince < spinTicks) {
+				spinPause();
+				continue;
+			}
+
+			// Announce first and look again after, so run() either sees us parked or we see its batch.
+			parked.store(true);
+
+			if (pool.batch.load() != seenBatch || threadShouldExit()) {
+				// Take the announcement back. If someone beat us to it, they're posting, so take the post.
+				if (parked.exchange(false))
+					break;
+			}
+
+			wakeUp.wait();
+		}
+
+		seenBatch = pool.batch.load(std::memory_order_acquire);
+
+		while (pool.runNextJob()) {}
+	}
+}
+
+//==============================================================================
+RealtimeWorkerPool::~RealtimeWorkerPool() {
+	release();
+}
+
+void RealtimeWorkerPool::prepare(int numWorkers, double callbackSeconds) {
+	spinTicks.store(juce::Time::secondsToHighResolutionTicks(callbackSeconds * spinFractionOfCallback), std::memory_order_relaxed);
+
+	const auto periodMs = callbackSeconds * 1000.0;
+
+	if (numWorkers == workers.size() && periodMs == callbackPeriodMs)
+		return;
+
+	release();
+	callbackPeriodMs = periodMs;
+
+	// The audio thread waits on these, so they get the same kind of scheduling it has.
+	const auto options = juce::Thread::RealtimeOptions{}.withPeriodMs(periodMs);
+
+	for (int i = 0; i < numWorkers; ++i) {
+		auto *worker = workers.add(new Worker(*this, i));
+
+		if (!worker->startRealtimeThread(options))
+			worker->startThread(juce::Thread::Priority::highest);
+	}
+}
+
+void RealtimeWorkerPool::release() {
+	for (auto *worker : workers)
+		worker->signalThreadShouldExit();
+
+	for (auto *worker : workers)
+		worker->stop();
+
+	workers.clear();
+}
+
+void RealtimeWorkerPool::runJobs(int numJobs, JobFunction function, void *context) {
+	if (numJobs <= 0)
+		return;
+
+	if (workers.isEmpty() || numJobs == 1) {
+		for (int i = 0; i < numJobs; ++i)
+			function(context, i);
+
+		return;
+	}
+
+	// Every job of the previous batch was claimed and finished before it returned,
+	// so nobody can be holding on to these.
+	jobFunction.store(function, std::memory_order_relaxed);
+	jobContext.store(context, std::memory_order_relaxed);
+	completedJobs.store(0, std::memory_order_relaxed);
+	claims.store(static_cast<uint64_t>(numJobs) << 32, std::memory_order_release);
+
+	batch.fetch_add(1);
+
+	for (auto *worker : workers)
+		worker->wake();
+
+	while (runNextJob()) {}
+
+	// Only jobs that are already running can be left, so this is a short wait.
+	while (completedJobs.load(std::memory_order_acquire) < numJobs)
+		spinPause();
+}
+
+bool RealtimeWorkerPool::runNextJob() {
+	const auto claim = claims.fetch_add(1, std::memory_order_acq_rel);
+
+	const auto index = static_cast<int>(claim & 0xffffffffu);
+	const auto numJobs = static_cast<int>(claim >> 32);
+
+	if (index >= numJobs)
+		return false;
+
+	jobFunction.load(std::memory_order_relaxed)(jobContext.load(std::memory_order_relaxed), index);
+
+	completedJobs.fetch_add(1, std::memory_order_release);
+	return true;
+}
@@ -0,0 +1,119 @@
+/*
+  ==============================================================================
+
+	RealtimeWorkerPool.h
+	Created: 16 Oct 2026 10:20:00pm
+	Author:  roeim
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+#include <atomic>
+#include <cstdint>
+
+#if JUCE_MAC || JUCE_IOS
+ #include <dispatch/dispatch.h>
+#elif ! JUCE_WINDOWS
+ #include <semaphore.h>
+#endif
+
+/*
+Splits one batch of independent jobs across a few pre-spawned threads and the calling thread.
+
+run() is real-time safe: it doesn't allocate, doesn't lock, and returns only once every job has
+finished, so whatever the jobs wrote is complete and visible when the caller carries on.
+Jobs are claimed from a single atomic counter. The caller claims jobs too, so a worker that was
+descheduled simply ends up doing less, and the caller never waits on a job nobody has started.
+
+A processBlock() call runs a burst of batches, one per control period. Between batches the workers
+spin, which is what lets them pick up the next one within microseconds. They only spin for a fraction
+of the host's callback period, so once the burst is over they park until the next run() instead of
+holding a core through the gap before the next callback. Waking a parked worker is a semaphore post,
+which takes no lock, and run() only posts to workers that actually parked.
+*/
+class RealtimeWorkerPool {
+public:
+	~RealtimeWorkerPool();
+
+	/**
+	Spawns numWorkers real-time threads, stopping any previous ones first. callbackSeconds is how long
+	the host's blocks last; the threads are scheduled for that period, and spin for a fraction of it
+	before they park. Not real-time safe.
+	*/
+	void prepare(int numWorkers, double callbackSeconds);
+
+	/** Stops and joins the workers. Not real-time safe. */
+	void release();
+
+	int getNumWorkers() const { return workers.size(); }
+
+	/** Calls job(index) for every index in [0, numJobs), spread across the pool and the calling thread. */
+	template<typename Callable>
+	void run(int numJobs, Callable &job) {
+		runJobs(numJobs, [](void *context, int index) { (*static_cast<Callable *>(context))(index); }, &job);
+	}
+
+private:
+	using JobFunction = void (*)(void *, int);
+
+	/** A counting semaphore straight from the OS. post() never takes a lock or allocates. */
+	struct Semaphore {
+		Semaphore();
+		~Semaphore();
+
+		void post();
+		void wait();
+
+	private:
+	   #if JUCE_MAC || JUCE_IOS
+		dispatch_semaphore_t semaphore;
+	   #elif JUCE_WINDOWS
+		void *semaphore;
+	   #else
+		sem_t semaphore;
+	   #endif
+
+		JUCE_DECLARE_NON_COPYABLE(Semaphore)
+	};
+
+	struct Worker: juce::Thread {
+		Worker(RealtimeWorkerPool &owner, int index);
+		~Worker() override;
+
+		void run() override;
+
+		/** Stops the thread and, if it's parked, wakes it so it can see that. */
+		void stop();
+
+		/** Posts wakeUp if the worker is parked. Exactly one caller gets to post for each park. */
+		void wake();
+
+		RealtimeWorkerPool &pool;
+		std::atomic<bool> parked{ false };
+		Semaphore wakeUp;
+	};
+
+	// How much of the callback period a worker spends spinning after its last batch before it parks.
+	static constexpr double spinFractionOfCallback = 0.125;
+
+	std::atomic<juce::int64> spinTicks{ 0 };
+	double callbackPeriodMs{ 0 };
+
+	juce::OwnedArray<Worker> workers;
+
+	// Job count in the upper 32 bits, next index to hand out in the lower 32.
+	// Resetting both in one store means a claim can never mix up two batches.
+	std::atomic<uint64_t> claims{ 0 };
+	std::atomic<uint32_t> batch{ 0 };
+	std::atomic<int> completedJobs{ 0 };
+
+	std::atomic<JobFunction> jobFunction{ nullptr };
+	std::atomic<void *> jobContext{ nullptr };
+
+	void runJobs(int numJobs, JobFunction function, void *context);
+	bool runNextJob();
+};
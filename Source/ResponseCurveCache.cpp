@@ -0,0 +1,152 @@
+/*
+  ==============================================================================
+
+	ResponseCurveCache.cpp
+	Created: 16 Oct 2026 9:40:00pm
+	Author:  roeim
+
+  ==============================================================================
+*/
+
+#include "ResponseCurveCache.h"
+
+namespace {
+	bool sameCoefficients(const BiquadCoefficients &a, const BiquadCoefficients &b) {
+		return a.b0 == b.b0 && a.b1 == b.b1 && a.b2 == b.b2 && a.a1 == b.a1 && a.a2 == b.a2;
+	}
+}
+
+bool ResponseCurveCache::prepare(int newNumPixels, double newSampleRate) {
+	newNumPixels = juce::jmax(0, newNumPixels);
+
+	if (newNumPixels == numPixels && newSampleRate == sampleRate)
+		return false;
+
+	numPixels = newNumPixels;
+	sampleRate = newSampleRate;
+
+	const auto numGroups = static_cast<size_t>((numPixels + lanes - 1) / lanes);
+
+	fillSinSquared(sinSquared, sampleRate);
+	fillSinSquared(oversampledSinSquared, sampleRate * (1 << oversamplingOrder));
+	numerators.assign(numGroups, SIMDDouble::expand(1.0));
+	denominators.assign(numGroups, SIMDDouble::expand(1.0));
+
+	for (auto &band : bands) {
+		band.valid = false;
+		band.decibels.assign(static_cast<size_t>(numPixels), 0.f);
+	}
+
+	totalDecibels.assign(static_cast<size_t>(numPixels), 0.f);
+
+	return true;
+}
+
+void ResponseCurveCache::fillSinSquared(std::vector<SIMDDouble> &table, double rate) const {
+	table.assign(static_cast<size_t>((numPixels + lanes - 1) / lanes), SIMDDouble::expand(0.0));
+
+	auto *s = reinterpret_cast<double *>(table.data());
+
+	for (int i = 0; i < numPixels; ++i) {
+		auto freq = juce::mapToLog10(static_cast<double>(i) / static_cast<double>(numPixels), 20.0, 20000.0);
+		auto sinHalfW = std::sin(juce::MathConstants<double>::pi * freq / rate);
+
+		s[i] = sinHalfW * sinHalfW;
+	}
+}
+
+bool ResponseCurveCache::update(const CoefficientSet &coefficients) {
+	// Linear phase runs the whole curve at the host rate, so it has to be designed for it.
+	jassert(!coefficients.linearPhase || coefficients.oversamplingOrder == 0);
+	const int order = coefficients.linearPhase ? 0 : coefficients.oversamplingOrder;
+
+	if (order != oversamplingOrder) {
+		oversamplingOrder = order;
+		fillSinSquared(oversampledSinSquared, sampleRate * (1 << oversamplingOrder));
+
+		for (int b = HighCutBand; b < numBands; ++b)
+			bands[static_cast<size_t>(b)].valid = false;
+	}
+
+	bool changed = updateBand(bands[LowCutBand], sinSquared, coefficients.lowCut.data(), coefficients.numLowCutStages);
+	changed |= updateBand(bands[HighCutBand], oversampledSinSquared, coefficients.highCut.data(), coefficients.numHighCutStages);
+
+	// A disabled peak is a band with no sections: flat, and evaluated only once.
+	for (size_t peak = 0; peak < coefficients.peaks.size(); ++peak)
+		changed |= updateBand(bands[firstPeakBand + peak], oversampledSinSquared, &coefficients.peaks[peak], coefficients.peakEnabled[peak] ? 1 : 0);
+
+	if (changed && numPixels > 0) {
+		juce::FloatVectorOperations::copy(totalDecibels.data(), bands[LowCutBand].decibels.data(), numPixels);
+
+		for (int b = HighCutBand; b < numBands; ++b)
+			if (bands[static_cast<size_t>(b)].numSections > 0)
+				juce::FloatVectorOperations::add(totalDecibels.data(), bands[static_cast<size_t>(b)].decibels.data(), numPixels);
+	}
+
+	return changed;
+}
+
+bool ResponseCurveCache::updateBand(BandState &band, const std::vector<SIMDDouble> &table,
+									const BiquadCoefficients *sections, int numSections) {
+	jassert(numSections <= static_cast<int>(band.sections.size()));
+
+	bool same = band.valid && band.numSections == numSections;
+
+	for (int i = 0; same && i < numSections; ++i)
+		same = sameCoefficients(band.sections[i], sections[i]);
+
+	if (same)
+		return false;
+
+	std::copy(sections, sections + numSections, band.sections.begin());
+	band.numSections = numSections;
+	band.valid = true;
+
+	evaluate(band, table);
+	return true;
+}
+
+void ResponseCurveCache::evaluate(BandState &band, const std::vector<SIMDDouble> &table) {
+	/*
+	For b0 + b1 z^-1 + b2 z^-2 at z = e^jw, with s = sin^2(w/2):
+	|N|^2 = (b0 + b1 + b2)^2 - 4s (b0 b1 + b1 b2 + 4 b0 b2) + 16 b0 b2 s^2
+	and the same for the denominator with (1, a1, a2).
+	Unlike the cos(w) form this doesn't cancel catastrophically at low frequencies,
+	where the cut filters' poles sit right next to z = 1.
+	*/
+	const auto numGroups = table.size();
+
+	for (size_t g = 0; g < numGroups; ++g) {
+		numerators[g] = SIMDDouble::expand(1.0);
+		denominators[g] = SIMDDouble::expand(1.0);
+	}
+
+	for (int i = 0; i < band.numSections; ++i) {
+		const double b0 = band.sections[i].b0, b1 = band.sections[i].b1, b2 = band.sections[i].b2;
+		const double a1 = band.sections[i].a1, a2 = band.sections[i].a2;
+
+		const auto nConst = SIMDDouble::expand(juce::square(b0 + b1 + b2));
+		const auto nLinear = SIMDDouble::expand(-4.0 * (b0 * b1 + b1 * b2 + 4.0 * b0 * b2));
+		const auto nQuadratic = SIMDDouble::expand(16.0 * b0 * b2);
+
+		const auto dConst = SIMDDouble::expand(juce::square(1.0 + a1 + a2));
+		const auto dLinear = SIMDDouble::expand(-4.0 * (a1 + a1 * a2 + 4.0 * a2));
+		const auto dQuadratic = SIMDDouble::expand(16.0 * a2);
+
+		for (size_t g = 0; g < numGroups; ++g) {
+			const auto s = table[g];
+
+			numerators[g] = numerators[g] * (nConst + s * (nLinear + s * nQuadratic));
+			denominators[g] = denominators[g] * (dConst + s * (dLinear + s * dQuadratic));
+		}
+	}
+
+	const auto *num = reinterpret_cast<const double *>(numerators.data());
+	const auto *den = reinterpret_cast<const double *>(denominators.data());
+
+	// One log per pixel per band, regardless of how many sections the band has.
+	for (int i = 0; i < numPixels; ++i) {
+		auto powerRatio = juce::jmax(num[i] / den[i], 1.0e-20);
+		band.decibels[static_cast<size_t>(i)] = static_cast<float>(10.0 * std::log10(powerRatio));
+	}
+}
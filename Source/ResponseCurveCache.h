@@ -0,0 +1,70 @@
+/*
+  ==============================================================================
+
+	ResponseCurveCache.h
+	Created: 16 Oct 2026 9:40:00pm
+	Author:  roeim
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "CoefficientDesign.h"
+
+/*
+The chain's magnitude response at every pixel column of the response curve, in dB.
+
+Each band (the low cut, every peak, the high cut) keeps its own curve and is only re-evaluated when
+its coefficients actually change, so moving one peak doesn't touch the other bands, and disabled
+peaks are left out of the sum. The per-pixel
+frequencies are turned into a sin^2(w/2) table once per resize or sample-rate change, and the
+closed-form biquad magnitude is evaluated over that table a SIMD register at a time. The peaks and
+high cut get a second table for the oversampled rate when the chain runs them oversampled, which
+it never does in linear phase mode.
+*/
+class ResponseCurveCache {
+public:
+	/** Rebuilds the frequency table if the width or sample rate changed. Returns true if it did. */
+	bool prepare(int numPixels, double sampleRate);
+
+	/** Re-evaluates the bands whose coefficients differ from last time. Returns true if any did. */
+	bool update(const CoefficientSet &coefficients);
+
+	/** The summed response, one value per pixel column. */
+	const std::vector<float> &getMagnitudesInDecibels() const { return totalDecibels; }
+
+private:
+	using SIMDDouble = juce::dsp::SIMDRegister<double>;
+	static constexpr int lanes = static_cast<int>(SIMDDouble::size());
+
+	enum Band {
+		LowCutBand,
+		HighCutBand,
+		firstPeakBand,
+		numBands = firstPeakBand + maxPeakBands
+	};
+
+	struct BandState {
+		std::array<BiquadCoefficients, 4> sections;
+		int numSections{ 0 };
+		bool valid{ false };
+		std::vector<float> decibels;
+	};
+
+	int numPixels{ 0 };
+	double sampleRate{ 0 };
+	int oversamplingOrder{ 0 };
+
+	// sin^2(w/2) per pixel, grouped into SIMD registers. The tail of the last group is padding.
+	std::vector<SIMDDouble> sinSquared, oversampledSinSquared;
+	std::vector<SIMDDouble> numerators, denominators;
+
+	std::array<BandState, numBands> bands;
+	std::vector<float> totalDecibels;
+
+	void fillSinSquared(std::vector<SIMDDouble> &table, double rate) const;
+	bool updateBand(BandState &band, const std::vector<SIMDDouble> &table, const BiquadCoefficients *sections, int numSections);
+	void evaluate(BandState &band, const std::vector<SIMDDouble> &table);
+};